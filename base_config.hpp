@@ -9,5 +9,39 @@
 #define VIDEO_HEIGHT 360 // 视频画面高度
 #define VIDEO_FPS 25 // 视频帧率
 #define VIDEO_BIT_RATE 1500000 // 视频比特率 480P: 1-2 Mbps, 720P: 2-3 Mbps, 1080P: 3-6 Mbps
+#define VIDEO_CODEC_H265 0 // 默认视频编码：0 = H.264，1 = H.265（需要 libx265）；平台 SDP 的 f= 行指定时以平台为准
+#define VIDEO_GOP_SIZE (VIDEO_FPS * 4) // GOP 长度（帧），新会话/平台请求时会强制 IDR，长 GOP 更省码率
+#define FORCED_IDR_MIN_INTERVAL_MS 1000 // 强制 IDR 最小间隔，期间的请求合并到下一次
+#define GOP_REPLAY_MAX_MS 500 // 新会话整组回放缓存 GOP 的跨度上限（毫秒），即起播画面最多落后实时的时长；更长时只回放 IDR 并请求新的 IDR
+#define GOP_CACHE_WHILE_IDLE 0 // 1 = 无会话时上一次点播的档位仍保持编码、持续缓存当前 GOP（采集 + 一路编码常驻，抵消空闲省电）；0（默认）= 完全空闲，起播使用唤醒后的 IDR
+#define SUB_VIDEO_WIDTH 320 // 子码流宽度（由主码流采集画面缩放）
+#define SUB_VIDEO_HEIGHT 180 // 子码流高度
+#define SUB_VIDEO_BIT_RATE 300000 // 子码流比特率
+#define FRAME_POOL_SIZE 6 // 下游同时持有的采集帧上限（每路编码器 排队 1 + 转换中 1，主/子码流共 4 + 采集中 1 + 余量 1），OpenCV 回退路径的缓冲池槽位数
+#define V4L2_BUFFER_COUNT (FRAME_POOL_SIZE + 2) // V4L2 驱动队列深度（mmap 缓冲区个数，即采集帧缓冲池），下游占满 FRAME_POOL_SIZE 个时驱动仍有 2 个可写
+#define COLOR_CONVERT_THREADS 2 // 颜色转换并行度（含转换线程自身），4 核设备 1080P 建议 2~3
+#define CONVERT_THREAD_CPU -1 // 颜色转换线程绑定的 CPU 核，-1 表示不绑定
+#define ENCODE_THREAD_CPU -1 // 编码线程绑定的 CPU 核，-1 表示不绑定
+#define ENCODE_GOVERNOR_ENABLE 1 // 编码负载调节：算力不足时逐级降帧率/分辨率，1 开启，0 关闭
+#define RTP_MAX_PAYLOAD 1400 // 单个 RTP 包的最大负载（PS 分片），MTU 1500 减去 IP/UDP/RTP 头并留有余量
+#define RTP_SEND_QUEUE_MAX_BYTES (VIDEO_BIT_RATE / 8) // 发送队列上限（字节），约为标称码率下 1 秒的数据，超出按 GOP 丢帧
+#define RTP_SEND_QUEUE_MAX_FRAMES 100 // 发送队列上限（帧，含音频帧）
+#define RTP_TCP_NOTSENT_LOWAT (64 * 1024) // TCP 内核中未发出数据的上限（TCP_NOTSENT_LOWAT），限制内核排队时延
+#define RTP_TCP_FRAMING_RFC4571 1 // TCP 分帧：1 = RFC 4571（2 字节长度前缀，GB28181 默认），0 = RTSP interleaved（$ + 通道 + 长度，兼容旧平台）
+// 发送路径开关可在编译选项中覆盖（如 -DRTP_UDP_BATCH=0），bench/rtp_sender_bench 以此对比不同路径
+#ifndef RTP_TCP_ZEROCOPY
+#define RTP_TCP_ZEROCOPY 0 // TCP 大帧使用 MSG_ZEROCOPY 发送（内核直接引用负载页面，需网卡支持 SG/校验和卸载），1 开启，0 关闭
+#endif
+#define RTP_TCP_ZEROCOPY_MIN_BYTES (64 * 1024) // 零拷贝发送的帧大小下限，小帧的页面固定与完成通知开销大于拷贝
+#ifndef RTP_UDP_BATCH
+#define RTP_UDP_BATCH 1 // UDP 按帧批量发送（一次 sendmmsg 发出一帧的多个 RTP 包），1 开启，0 逐包 sendmsg
+#endif
+#ifndef RTP_UDP_GSO
+#define RTP_UDP_GSO 1 // UDP 批量发送时连续等长的 RTP 包合并为一个 GSO 消息（UDP_SEGMENT），内核不支持时自动关闭
+#endif
+#ifndef RTP_IO_URING
+#define RTP_IO_URING 0 // UDP 使用 io_uring 发送（一帧的请求一次提交、异步回收完成事件），内核不支持时回退到 sendmmsg，1 开启，0 关闭
+#endif
+#define VIDEO_MTU_SLICES 1 // 按 RTP 包大小限制 H.264 条带大小，丢一个 UDP 包只损坏一个条带，1 开启，0 关闭
 
 #endif //GB28181CONSOLE_BASE_CONFIG_HPP
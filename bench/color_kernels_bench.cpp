@@ -0,0 +1,246 @@
+//
+// Created by pengx on 2026/10/16.
+//
+
+/**
+ * 颜色转换内核的一致性校验与微基准
+ *
+ * 1. 校验：当前 CPU 支持的每个 SIMD 实现与标量参考实现在随机数据、极值数据、各种行尾宽度下逐字节比对，
+ *    同时检查目标缓冲区末尾的哨兵字节未被越界写入，任何不一致都以非零退出码结束
+ * 2. 基准：360p / 720p / 1080p 单线程整帧转换耗时（中位数），BGR24 / YUYV / NV12 三种输入
+ *
+ * 用法：color_kernels_bench [每项重复次数，默认 50]
+ * */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "color_kernels.hpp"
+
+namespace {
+constexpr uint8_t GUARD = 0xA5;
+constexpr int GUARD_BYTES = 64;
+
+enum class Pattern { RANDOM, ZERO, FULL, ALTERNATE };
+
+void fill(std::vector<uint8_t>& buffer, const Pattern pattern, std::mt19937& rng) {
+    for (size_t i = 0; i < buffer.size(); ++i) {
+        switch (pattern) {
+        case Pattern::RANDOM:
+            buffer[i] = static_cast<uint8_t>(rng());
+            break;
+        case Pattern::ZERO:
+            buffer[i] = 0;
+            break;
+        case Pattern::FULL:
+            buffer[i] = 255;
+            break;
+        case Pattern::ALTERNATE:
+            buffer[i] = (i / 3) % 2 ? 255 : 0;
+            break;
+        }
+    }
+}
+
+/**
+ * 一对亮度行的输出，每个平面末尾带哨兵
+ */
+struct RowPairOutput {
+    explicit RowPairOutput(const int width)
+        : y0(width + GUARD_BYTES, GUARD), y1(width + GUARD_BYTES, GUARD), u(width / 2 + GUARD_BYTES, GUARD),
+          v(width / 2 + GUARD_BYTES, GUARD) {}
+
+    bool operator==(const RowPairOutput& other) const {
+        return y0 == other.y0 && y1 == other.y1 && u == other.u && v == other.v;
+    }
+
+    std::vector<uint8_t> y0, y1, u, v;
+};
+
+bool check_row_pair(const char* kernel_name, const char* format, const RowPairKernel reference,
+                    const RowPairKernel kernel, const int width, const int bytes_per_pixel, const Pattern pattern,
+                    std::mt19937& rng) {
+    std::vector<uint8_t> src0(width * bytes_per_pixel), src1(width * bytes_per_pixel);
+    fill(src0, pattern, rng);
+    fill(src1, pattern == Pattern::ALTERNATE ? Pattern::RANDOM : pattern, rng);
+
+    RowPairOutput expected(width), actual(width);
+    reference(src0.data(), src1.data(), expected.y0.data(), expected.y1.data(), expected.u.data(),
+              expected.v.data(), width);
+    kernel(src0.data(), src1.data(), actual.y0.data(), actual.y1.data(), actual.u.data(), actual.v.data(), width);
+    if (actual == expected) {
+        return true;
+    }
+    printf("MISMATCH: %s %s width=%d pattern=%d\n", kernel_name, format, width, static_cast<int>(pattern));
+    return false;
+}
+
+bool check_split_uv(const char* kernel_name, const SplitUvKernel reference, const SplitUvKernel kernel,
+                    const int chroma_width, const Pattern pattern, std::mt19937& rng) {
+    std::vector<uint8_t> src(chroma_width * 2);
+    fill(src, pattern, rng);
+    std::vector<uint8_t> expected_u(chroma_width + GUARD_BYTES, GUARD), expected_v(expected_u);
+    std::vector<uint8_t> actual_u(expected_u), actual_v(expected_u);
+    reference(src.data(), expected_u.data(), expected_v.data(), chroma_width);
+    kernel(src.data(), actual_u.data(), actual_v.data(), chroma_width);
+    if (actual_u == expected_u && actual_v == expected_v) {
+        return true;
+    }
+    printf("MISMATCH: %s NV12 chroma_width=%d pattern=%d\n", kernel_name, chroma_width,
+           static_cast<int>(pattern));
+    return false;
+}
+
+bool verify(const std::vector<const ColorKernels*>& all) {
+    const ColorKernels& reference = scalarColorKernels();
+    std::vector<int> widths;
+    // 覆盖所有向量宽度（最多 32 像素）的行尾情况
+    for (int width = 2; width <= 130; width += 2) {
+        widths.push_back(width);
+    }
+    widths.insert(widths.end(), {640, 1280, 1920, 3840});
+
+    std::mt19937 rng(28181);
+    bool ok = true;
+    size_t cases = 0;
+    for (const ColorKernels* kernels : all) {
+        if (kernels == &reference) {
+            continue;
+        }
+        for (const int width : widths) {
+            for (const Pattern pattern : {Pattern::RANDOM, Pattern::ZERO, Pattern::FULL, Pattern::ALTERNATE}) {
+                // 随机数据多跑几轮
+                const int rounds = pattern == Pattern::RANDOM ? 16 : 1;
+                for (int round = 0; round < rounds; ++round) {
+                    ok &= check_row_pair(kernels->name, "BGR24", reference.bgr24, kernels->bgr24, width, 3, pattern,
+                                         rng);
+                    ok &= check_row_pair(kernels->name, "YUYV", reference.yuyv, kernels->yuyv, width, 2, pattern,
+                                         rng);
+                    ok &= check_split_uv(kernels->name, reference.split_uv, kernels->split_uv, width / 2, pattern,
+                                         rng);
+                    cases += 3;
+                }
+            }
+        }
+    }
+    printf("bit-exact check: %zu cases, %s\n", cases, ok ? "OK" : "FAILED");
+    return ok;
+}
+
+struct Frame {
+    Frame(const int width, const int height)
+        : width(width), height(height), bgr(width * height * 3), yuyv(width * height * 2),
+          nv12(width * height * 3 / 2), i420(width * height * 3 / 2) {}
+
+    int width, height;
+    std::vector<uint8_t> bgr, yuyv, nv12, i420;
+};
+
+enum class Format { BGR24, YUYV, NV12 };
+
+void convert(const ColorKernels& kernels, Frame& frame, const Format format) {
+    const int width = frame.width;
+    const int height = frame.height;
+    uint8_t* dst_y = frame.i420.data();
+    uint8_t* dst_u = dst_y + width * height;
+    uint8_t* dst_v = dst_u + width * height / 4;
+    switch (format) {
+    case Format::BGR24:
+    case Format::YUYV: {
+        const bool bgr = format == Format::BGR24;
+        const int stride = bgr ? width * 3 : width * 2;
+        const uint8_t* src = bgr ? frame.bgr.data() : frame.yuyv.data();
+        const RowPairKernel kernel = bgr ? kernels.bgr24 : kernels.yuyv;
+        for (int y = 0; y < height; y += 2) {
+            const uint8_t* src0 = src + y * stride;
+            kernel(src0, src0 + stride, dst_y + y * width, dst_y + (y + 1) * width, dst_u + y / 2 * width / 2,
+                   dst_v + y / 2 * width / 2, width);
+        }
+        break;
+    }
+    case Format::NV12: {
+        memcpy(dst_y, frame.nv12.data(), width * height);
+        const uint8_t* src_uv = frame.nv12.data() + width * height;
+        for (int y = 0; y < height / 2; ++y) {
+            kernels.split_uv(src_uv + y * width, dst_u + y * width / 2, dst_v + y * width / 2, width / 2);
+        }
+        break;
+    }
+    }
+}
+
+double measure_us(const ColorKernels& kernels, Frame& frame, const Format format, const int repeat) {
+    std::vector<double> samples;
+    samples.reserve(repeat);
+    convert(kernels, frame, format); // 预热
+    for (int i = 0; i < repeat; ++i) {
+        const auto start = std::chrono::steady_clock::now();
+        convert(kernels, frame, format);
+        samples.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count());
+    }
+    std::sort(samples.begin(), samples.end());
+    return samples[samples.size() / 2];
+}
+
+void benchmark(const std::vector<const ColorKernels*>& all, const int repeat) {
+    struct Resolution {
+        const char* name;
+        int width;
+        int height;
+    };
+    const Resolution resolutions[] = {{"360p", 640, 360}, {"720p", 1280, 720}, {"1080p", 1920, 1080}};
+    const struct {
+        const char* name;
+        Format format;
+    } formats[] = {{"BGR24", Format::BGR24}, {"YUYV", Format::YUYV}, {"NV12", Format::NV12}};
+
+    std::mt19937 rng(2026);
+    printf("\nsingle-thread frame conversion, median of %d runs (us)\n", repeat);
+    printf("%-6s %-6s", "res", "input");
+    for (const ColorKernels* kernels : all) {
+        printf(" %10s", kernels->name);
+    }
+    printf(" %10s\n", "speedup");
+    for (const auto& resolution : resolutions) {
+        Frame frame(resolution.width, resolution.height);
+        fill(frame.bgr, Pattern::RANDOM, rng);
+        fill(frame.yuyv, Pattern::RANDOM, rng);
+        fill(frame.nv12, Pattern::RANDOM, rng);
+        for (const auto& format : formats) {
+            printf("%-6s %-6s", resolution.name, format.name);
+            double scalar_us = 0;
+            double best_us = 0;
+            for (const ColorKernels* kernels : all) {
+                const double us = measure_us(*kernels, frame, format.format, repeat);
+                if (kernels == &scalarColorKernels()) {
+                    scalar_us = us;
+                }
+                best_us = us;
+                printf(" %10.1f", us);
+            }
+            printf(" %9.1fx\n", scalar_us / best_us);
+        }
+    }
+}
+} // namespace
+
+int main(const int argc, char** argv) {
+    const int repeat = argc > 1 ? std::max(1, atoi(argv[1])) : 50;
+    const auto all = supportedColorKernels();
+    printf("kernels:");
+    for (const ColorKernels* kernels : all) {
+        printf(" %s", kernels->name);
+    }
+    printf(" (best: %s)\n", bestColorKernels().name);
+
+    if (!verify(all)) {
+        return 1;
+    }
+    benchmark(all, repeat);
+    return 0;
+}
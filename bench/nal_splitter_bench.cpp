@@ -0,0 +1,219 @@
+//
+// Created by pengx on 2026/10/16.
+//
+
+/**
+ * NalSplitter 微基准：memchr 跳读起始码 + 定长 NALU 数组，对比原来逐字节比较 + 临时 vector 的 H264Splitter
+ *
+ * 输入为编码器输出的 Annex B 码流文件（如 x264 在不同码率、是否按 MTU 切条带下的输出），按访问单元切成帧后
+ * 逐帧调用两种实现：先校验两者切分结果完全一致，再统计每帧耗时与吞吐。
+ *
+ * 用法：nal_splitter_bench [重复轮数，默认 20] <码流文件.h264>...
+ * */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "nal_splitter.hpp"
+
+namespace {
+/**
+ * 原 H264Splitter::splitH264Frame：逐字节比较起始码，每次调用分配两个临时 vector
+ */
+size_t legacy_split(const uint8_t* frame, const size_t frame_size, std::vector<NALU>& nalu_vector) {
+    if (frame == nullptr || frame_size == 0) {
+        return 0;
+    }
+
+    nalu_vector.clear();
+    size_t i = 0;
+
+    std::vector<size_t> start_positions;
+    std::vector<size_t> start_code_lengths;
+
+    while (i < frame_size) {
+        if (i + 3 < frame_size && frame[i] == 0x00 && frame[i + 1] == 0x00 && frame[i + 2] == 0x00 &&
+            frame[i + 3] == 0x01) {
+            start_positions.push_back(i);
+            start_code_lengths.push_back(4);
+            i += 4;
+            continue;
+        }
+        if (i + 2 < frame_size && frame[i] == 0x00 && frame[i + 1] == 0x00 && frame[i + 2] == 0x01) {
+            start_positions.push_back(i);
+            start_code_lengths.push_back(3);
+            i += 3;
+            continue;
+        }
+        i++;
+    }
+
+    if (start_positions.empty()) {
+        return 0;
+    }
+
+    for (size_t idx = 0; idx < start_positions.size(); idx++) {
+        const size_t nalu_start = start_positions[idx] + start_code_lengths[idx];
+        const size_t nalu_end = idx + 1 < start_positions.size() ? start_positions[idx + 1] : frame_size;
+        if (nalu_end > nalu_start && nalu_start < frame_size) {
+            NALU nalu{};
+            nalu.data = const_cast<uint8_t*>(frame + nalu_start);
+            nalu.size = nalu_end - nalu_start;
+            nalu.type = nalu.data[0] & 0x1F;
+            nalu_vector.push_back(nalu);
+        }
+    }
+    return nalu_vector.size();
+}
+
+struct AccessUnit {
+    const uint8_t* data;
+    size_t size;
+};
+
+/**
+ * H.264 码流按访问单元切帧：参数集 / SEI / AUD，或 first_mb_in_slice == 0 的条带出现在已有条带之后时开始新的一帧
+ */
+std::vector<AccessUnit> split_access_units(const std::vector<uint8_t>& stream) {
+    std::vector<AccessUnit> units;
+    const uint8_t* data = stream.data();
+    const size_t size = stream.size();
+    size_t unit_start = 0;
+    bool has_slice = false;
+    for (size_t i = 0; i + 3 < size; ++i) {
+        if (data[i] != 0x00 || data[i + 1] != 0x00 || data[i + 2] != 0x01) {
+            continue;
+        }
+        const size_t start_code = i > 0 && data[i - 1] == 0x00 ? i - 1 : i;
+        const int type = data[i + 3] & 0x1F;
+        const bool is_slice = type == 1 || type == 5;
+        // first_mb_in_slice 为 ue(v)，值为 0 时第一位是 1
+        const bool is_first_slice = is_slice && i + 4 < size && (data[i + 4] & 0x80) != 0;
+        const bool is_prefix = type == 6 || type == 7 || type == 8 || type == 9;
+        if (has_slice && (is_prefix || is_first_slice)) {
+            units.push_back({data + unit_start, start_code - unit_start});
+            unit_start = start_code;
+            has_slice = false;
+        }
+        has_slice |= is_slice;
+        i += 2;
+    }
+    if (unit_start < size) {
+        units.push_back({data + unit_start, size - unit_start});
+    }
+    return units;
+}
+
+bool verify(const std::vector<AccessUnit>& units, size_t& nalu_total) {
+    std::vector<NALU> expected;
+    NALU actual[NalSplitter::MAX_NALU_PER_FRAME];
+    nalu_total = 0;
+    for (const auto& unit : units) {
+        const size_t expected_count = legacy_split(unit.data, unit.size, expected);
+        const size_t actual_count = NalSplitter::get()->split(unit.data, unit.size, VideoCodec::H264, actual,
+                                                              NalSplitter::MAX_NALU_PER_FRAME);
+        if (expected_count != actual_count) {
+            printf("MISMATCH: NALU count %zu vs %zu\n", expected_count, actual_count);
+            return false;
+        }
+        for (size_t i = 0; i < actual_count; ++i) {
+            if (expected[i].data != actual[i].data || expected[i].size != actual[i].size ||
+                expected[i].type != actual[i].type) {
+                printf("MISMATCH: NALU %zu of a %zu byte frame\n", i, unit.size);
+                return false;
+            }
+        }
+        nalu_total += actual_count;
+    }
+    return true;
+}
+
+template <typename Split>
+double measure_ns_per_frame(const std::vector<AccessUnit>& units, const int rounds, Split split) {
+    std::vector<double> samples;
+    samples.reserve(rounds);
+    size_t sink = 0;
+    for (int round = 0; round <= rounds; ++round) {
+        const auto start = std::chrono::steady_clock::now();
+        for (const auto& unit : units) {
+            sink += split(unit);
+        }
+        const double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        // 第 0 轮预热
+        if (round > 0) {
+            samples.push_back(ns / static_cast<double>(units.size()));
+        }
+    }
+    if (sink == 0) {
+        printf("no NALU found\n");
+    }
+    std::sort(samples.begin(), samples.end());
+    return samples[samples.size() / 2];
+}
+} // namespace
+
+int main(const int argc, char** argv) {
+    int first_file = 1;
+    int rounds = 20;
+    if (argc > 1 && std::string(argv[1]).find_first_not_of("0123456789") == std::string::npos) {
+        rounds = std::max(1, atoi(argv[1]));
+        first_file = 2;
+    }
+    if (first_file >= argc) {
+        printf("usage: %s [rounds] <stream.h264>...\n", argv[0]);
+        return 1;
+    }
+
+    // 单例构造时会打印日志，先于表头创建
+    NalSplitter::get();
+    printf("median of %d rounds\n", rounds);
+    printf("%-24s %7s %9s %9s | %11s %11s | %11s %11s %8s\n", "stream", "frames", "avg bytes", "NALU/frm",
+           "legacy ns", "memchr ns", "legacy MB/s", "memchr MB/s", "speedup");
+    bool ok = true;
+    for (int i = first_file; i < argc; ++i) {
+        std::ifstream file(argv[i], std::ios::binary);
+        if (!file) {
+            printf("cannot open %s\n", argv[i]);
+            ok = false;
+            continue;
+        }
+        const std::vector<uint8_t> stream((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        const auto units = split_access_units(stream);
+        if (units.empty()) {
+            printf("%s: no access unit\n", argv[i]);
+            ok = false;
+            continue;
+        }
+
+        size_t nalu_total = 0;
+        if (!verify(units, nalu_total)) {
+            printf("%s: results differ from the legacy splitter\n", argv[i]);
+            ok = false;
+            continue;
+        }
+
+        std::vector<NALU> legacy_nalus;
+        const double legacy_ns = measure_ns_per_frame(units, rounds, [&](const AccessUnit& unit) {
+            return legacy_split(unit.data, unit.size, legacy_nalus);
+        });
+        NALU nalus[NalSplitter::MAX_NALU_PER_FRAME];
+        const double memchr_ns = measure_ns_per_frame(units, rounds, [&](const AccessUnit& unit) {
+            return NalSplitter::get()->split(unit.data, unit.size, VideoCodec::H264, nalus,
+                                             NalSplitter::MAX_NALU_PER_FRAME);
+        });
+
+        const double avg_bytes = static_cast<double>(stream.size()) / static_cast<double>(units.size());
+        std::string name = argv[i];
+        name = name.substr(name.find_last_of('/') + 1);
+        printf("%-24s %7zu %9.0f %9.1f | %11.0f %11.0f | %11.0f %11.0f %7.1fx\n", name.c_str(), units.size(),
+               avg_bytes, static_cast<double>(nalu_total) / static_cast<double>(units.size()), legacy_ns, memchr_ns,
+               avg_bytes * 1000.0 / legacy_ns, avg_bytes * 1000.0 / memchr_ns, legacy_ns / memchr_ns);
+    }
+    return ok ? 0 : 1;
+}
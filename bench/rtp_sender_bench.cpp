@@ -0,0 +1,415 @@
+//
+// Created by pengx on 2026/10/16.
+//
+
+/**
+ * RtpSender 发送路径基准：按给定码率/帧率向本机接收端推送 PS 帧，统计系统调用次数与 CPU 开销
+ *
+ * 帧的分段形状与 PsMuxer 的输出一致：PS 头 + PES 头 + 按 MTU 条带（slice-max-size + 起始码）切开的负载，
+ * 每路会话一个 RtpSender 实例（各自的发送线程与 socket）。接收端运行在 fork 出的子进程中，
+ * 其 CPU 不计入结果；但回环上报文的接收处理（软中断）大部分发生在发送方的系统调用中，会计入发送方的系统态时间。
+ *
+ * 发送路径是编译期开关（base_config.hpp），同一份源码以不同的 -D 选项编译为多个程序分别运行对比：
+ *   rtp_sender_bench            默认配置（UDP 按帧 sendmmsg + GSO）
+ *   rtp_sender_bench_no_gso     UDP 按帧 sendmmsg，不合并 GSO
+ *   rtp_sender_bench_per_packet UDP 逐包 sendmsg（批量发送之前的路径）
+ *   rtp_sender_bench_io_uring   UDP 经 io_uring 提交（内核不支持时 RtpSender 打印告警并回退到 sendmmsg），
+ *                               此时 syscalls 为 io_uring_enter 次数
+ *   rtp_sender_bench_zerocopy   TCP 不小于 RTP_TCP_ZEROCOPY_MIN_BYTES 的帧以 MSG_ZEROCOPY 发送
+ * 多路会话各自的发送线程并发运行，用于观察 pps 上升时各路径的 CPU 开销。
+ *
+ * 零拷贝只有经过支持 SG/校验和卸载的真实网卡才生效：回环上内核总是回退为拷贝（完成通知带 COPIED），
+ * RtpSender 收到第一个这样的通知后即关闭零拷贝，之后的帧走普通拷贝路径，结果中会明确提示本次未测到零拷贝。
+ * 经网卡测量时在对端运行接收端，发送端指定对端地址，此时不再 fork 本机接收端：
+ *   对端：rtp_sender_bench sink <udp|tcp> <起始端口> [会话数]（每秒打印接收速率，Ctrl-C 结束）
+ *   本机：rtp_sender_bench_zerocopy tcp <会话数> <码率> <秒数> <帧率> <对端IP:起始端口>
+ * 内核拷贝量按「发送字节数 - 未被回退为拷贝的零拷贝帧字节数」估算，供对比内存带宽占用。
+ *
+ * 用法：rtp_sender_bench <udp|tcp> [会话数，默认 1] [每路码率 Mbit/s，默认 8] [秒数，默认 5] [帧率，默认 25]
+ *                        [对端IP:起始端口，默认本机接收子进程]
+ * */
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "rtp_sender.hpp"
+
+namespace {
+constexpr size_t PS_HEADER_BYTES = 20;
+constexpr size_t PES_HEADER_BYTES = 14;
+// VIDEO_MTU_SLICES 下一个条带 NALU（slice-max-size + 4 字节起始码）
+constexpr size_t SLICE_SEGMENT_BYTES = 1328;
+constexpr int SINK_BATCH = 64;
+constexpr size_t SINK_BUFFER_BYTES = 2048;
+
+struct Options {
+    bool is_tcp = false;
+    int sessions = 1;
+    double mbps = 8;
+    int seconds = 5;
+    int fps = 25;
+    std::string remote_host; // 为空时 fork 本机接收端
+    int remote_port = 0;
+};
+
+struct SinkTotals {
+    uint64_t packets = 0; // UDP 数据报个数（TCP 不统计）
+    uint64_t bytes = 0;
+};
+
+/**
+ * 接收端：UDP 绑定端口 / TCP 监听端口，port 为 0 时绑定回环地址、端口号由内核分配
+ */
+int open_sink_socket(const bool is_tcp, int& port) {
+    const int fd = socket(AF_INET, (is_tcp ? SOCK_STREAM : SOCK_DGRAM) | SOCK_NONBLOCK, 0);
+    if (fd < 0) {
+        return -1;
+    }
+    constexpr int receive_buffer_size = 8 * 1024 * 1024;
+    setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &receive_buffer_size, sizeof(receive_buffer_size));
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(port == 0 ? INADDR_LOOPBACK : INADDR_ANY);
+    addr.sin_port = htons(port);
+    socklen_t len = sizeof(addr);
+    if (bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 || (is_tcp && listen(fd, 16) < 0) ||
+        getsockname(fd, reinterpret_cast<sockaddr*>(&addr), &len) < 0) {
+        close(fd);
+        return -1;
+    }
+    port = ntohs(addr.sin_port);
+    return fd;
+}
+
+/**
+ * 接收端：收空所有 socket，control_fd 可读时把累计结果写回并退出；control_fd < 0 时（对端独立运行）每秒打印接收速率
+ */
+void run_sink(const std::vector<int>& fds, const bool is_tcp, const int control_fd) {
+    const int epoll_fd = epoll_create1(0);
+    epoll_event event{};
+    event.events = EPOLLIN;
+    for (const int fd : fds) {
+        event.data.fd = fd;
+        epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &event);
+    }
+    if (control_fd >= 0) {
+        event.data.fd = control_fd;
+        epoll_ctl(epoll_fd, EPOLL_CTL_ADD, control_fd, &event);
+    }
+
+    std::vector<uint8_t> buffers(SINK_BATCH * SINK_BUFFER_BYTES);
+    iovec iovs[SINK_BATCH];
+    mmsghdr msgs[SINK_BATCH];
+    SinkTotals totals;
+    SinkTotals reported;
+    auto report_time = std::chrono::steady_clock::now();
+    epoll_event events[16];
+    while (true) {
+        const int count = epoll_wait(epoll_fd, events, 16, control_fd >= 0 ? -1 : 100);
+        if (control_fd < 0 && std::chrono::steady_clock::now() - report_time >= std::chrono::seconds(1)) {
+            report_time += std::chrono::seconds(1);
+            printf("received %.1f Mbit/s, %llu packets/s\n",
+                   static_cast<double>(totals.bytes - reported.bytes) * 8 / 1e6, static_cast<unsigned long long>(totals.packets - reported.packets));
+            fflush(stdout);
+            reported = totals;
+        }
+        for (int i = 0; i < count; ++i) {
+            const int fd = events[i].data.fd;
+            if (fd == control_fd) {
+                write(control_fd, &totals, sizeof(totals));
+                _exit(0);
+            }
+            if (is_tcp && std::find(fds.begin(), fds.end(), fd) != fds.end()) {
+                const int connection = accept4(fd, nullptr, nullptr, SOCK_NONBLOCK);
+                if (connection >= 0) {
+                    event.data.fd = connection;
+                    epoll_ctl(epoll_fd, EPOLL_CTL_ADD, connection, &event);
+                }
+                continue;
+            }
+            if (is_tcp) {
+                ssize_t ret;
+                while ((ret = read(fd, buffers.data(), buffers.size())) > 0) {
+                    totals.bytes += ret;
+                }
+                if (ret == 0) {
+                    close(fd);
+                }
+                continue;
+            }
+            while (true) {
+                for (int j = 0; j < SINK_BATCH; ++j) {
+                    iovs[j] = {buffers.data() + j * SINK_BUFFER_BYTES, SINK_BUFFER_BYTES};
+                    msgs[j] = {};
+                    msgs[j].msg_hdr.msg_iov = &iovs[j];
+                    msgs[j].msg_hdr.msg_iovlen = 1;
+                }
+                const int received = recvmmsg(fd, msgs, SINK_BATCH, MSG_DONTWAIT, nullptr);
+                if (received <= 0) {
+                    break;
+                }
+                totals.packets += received;
+                for (int j = 0; j < received; ++j) {
+                    totals.bytes += msgs[j].msg_len;
+                }
+            }
+        }
+    }
+}
+
+/**
+ * 进程（全部线程）累计 CPU 时间；getrusage 的用户态/系统态划分按时钟节拍采样，只用于看比例
+ */
+double process_cpu_ms() {
+    timespec ts{};
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return ts.tv_sec * 1e3 + ts.tv_nsec / 1e6;
+}
+
+double user_ms(const rusage& usage) {
+    return usage.ru_utime.tv_sec * 1e3 + usage.ru_utime.tv_usec / 1e3;
+}
+
+double system_ms(const rusage& usage) {
+    return usage.ru_stime.tv_sec * 1e3 + usage.ru_stime.tv_usec / 1e3;
+}
+
+/**
+ * 按 PsMuxer 的分段形状填充一帧：头部写在帧自带的缓冲区，负载引用共享缓冲区
+ */
+void fill_frame(RtpSender::Frame& frame, const std::shared_ptr<std::vector<uint8_t>>& payload,
+                const size_t payload_bytes, const uint32_t timestamp, const bool is_key_frame) {
+    frame.segments.clear();
+    frame.segments.push_back({frame.headers, PS_HEADER_BYTES});
+    frame.segments.push_back({frame.headers + PS_HEADER_BYTES, PES_HEADER_BYTES});
+    for (size_t offset = 0; offset < payload_bytes; offset += SLICE_SEGMENT_BYTES) {
+        frame.segments.push_back({payload->data() + offset, std::min(SLICE_SEGMENT_BYTES, payload_bytes - offset)});
+    }
+    frame.payload_owner = payload;
+    frame.timestamp = timestamp;
+    frame.is_video = true;
+    frame.is_key_frame = is_key_frame;
+    frame.is_droppable = false;
+    frame.is_replayed = false;
+}
+
+bool parse_options(const int argc, char** argv, Options& options) {
+    if (argc < 2 || (strcmp(argv[1], "udp") != 0 && strcmp(argv[1], "tcp") != 0)) {
+        return false;
+    }
+    options.is_tcp = strcmp(argv[1], "tcp") == 0;
+    options.sessions = argc > 2 ? std::max(1, atoi(argv[2])) : options.sessions;
+    options.mbps = argc > 3 ? std::max(0.1, atof(argv[3])) : options.mbps;
+    options.seconds = argc > 4 ? std::max(1, atoi(argv[4])) : options.seconds;
+    options.fps = argc > 5 ? std::max(1, atoi(argv[5])) : options.fps;
+    if (argc > 6) {
+        const std::string remote = argv[6];
+        const size_t colon = remote.find(':');
+        if (colon == std::string::npos) {
+            return false;
+        }
+        options.remote_host = remote.substr(0, colon);
+        options.remote_port = atoi(remote.c_str() + colon + 1);
+    }
+    return true;
+}
+
+/**
+ * 对端独立运行的接收端：rtp_sender_bench sink <udp|tcp> <起始端口> [会话数]
+ */
+int run_remote_sink(const int argc, char** argv) {
+    if (argc < 4 || (strcmp(argv[2], "udp") != 0 && strcmp(argv[2], "tcp") != 0) || atoi(argv[3]) <= 0) {
+        printf("usage: %s sink <udp|tcp> <first port> [sessions]\n", argv[0]);
+        return 1;
+    }
+    const bool is_tcp = strcmp(argv[2], "tcp") == 0;
+    const int sessions = argc > 4 ? std::max(1, atoi(argv[4])) : 1;
+    std::vector<int> fds;
+    for (int i = 0; i < sessions; ++i) {
+        int port = atoi(argv[3]) + i;
+        const int fd = open_sink_socket(is_tcp, port);
+        if (fd < 0) {
+            printf("cannot listen on port %d: %s\n", port, strerror(errno));
+            return 1;
+        }
+        fds.push_back(fd);
+    }
+    printf("%s sink on ports %d-%d\n", is_tcp ? "tcp" : "udp", atoi(argv[3]), atoi(argv[3]) + sessions - 1);
+    run_sink(fds, is_tcp, -1);
+    return 0;
+}
+} // namespace
+
+int main(const int argc, char** argv) {
+    if (argc > 1 && strcmp(argv[1], "sink") == 0) {
+        return run_remote_sink(argc, argv);
+    }
+    Options options;
+    if (!parse_options(argc, argv, options)) {
+        printf("usage: %s <udp|tcp> [sessions] [Mbit/s per session] [seconds] [fps] [host:first port]\n"
+               "       %s sink <udp|tcp> <first port> [sessions]\n", argv[0], argv[0]);
+        return 1;
+    }
+
+    const bool is_local = options.remote_host.empty();
+    std::vector<int> sink_fds;
+    std::vector<int> ports;
+    for (int i = 0; is_local && i < options.sessions; ++i) {
+        int port = 0;
+        const int fd = open_sink_socket(options.is_tcp, port);
+        if (fd < 0) {
+            printf("cannot open sink socket: %s\n", strerror(errno));
+            return 1;
+        }
+        sink_fds.push_back(fd);
+        ports.push_back(port);
+    }
+    int control[2] = {-1, -1};
+    pid_t sink_pid = -1;
+    if (is_local) {
+        if (socketpair(AF_UNIX, SOCK_STREAM, 0, control) < 0) {
+            printf("socketpair failed: %s\n", strerror(errno));
+            return 1;
+        }
+        sink_pid = fork();
+        if (sink_pid == 0) {
+            close(control[0]);
+            run_sink(sink_fds, options.is_tcp, control[1]);
+        }
+        close(control[1]);
+        for (const int fd : sink_fds) {
+            close(fd);
+        }
+    }
+
+    std::vector<std::unique_ptr<RtpSender>> senders;
+    for (int i = 0; i < options.sessions; ++i) {
+        SdpStruct sdp;
+        sdp.remote_host = is_local ? "127.0.0.1" : options.remote_host;
+        sdp.remote_port = is_local ? ports[i] : options.remote_port + i;
+        sdp.transport = options.is_tcp ? "tcp" : "udp";
+        sdp.ssrc = std::to_string(100000000 + i);
+        senders.emplace_back(new RtpSender());
+        if (!(options.is_tcp ? senders.back()->initTcpSocket(sdp) : senders.back()->initUdpSocket(sdp))) {
+            printf("session %d: init failed\n", i);
+            return 1;
+        }
+    }
+
+    const size_t target_frame_bytes = static_cast<size_t>(options.mbps * 1e6 / 8 / options.fps);
+    const size_t payload_bytes =
+            std::max(PS_HEADER_BYTES + PES_HEADER_BYTES + 1, target_frame_bytes) - PS_HEADER_BYTES - PES_HEADER_BYTES;
+    auto payload = std::make_shared<std::vector<uint8_t>>(payload_bytes, 0x5A);
+    const int total_frames = options.seconds * options.fps;
+    const auto interval = std::chrono::microseconds(1000000 / options.fps);
+
+    rusage usage_start{};
+    getrusage(RUSAGE_SELF, &usage_start);
+    const double cpu_start_ms = process_cpu_ms();
+    const auto start = std::chrono::steady_clock::now();
+    for (int n = 0; n < total_frames; ++n) {
+        std::this_thread::sleep_until(start + interval * n);
+        const uint32_t timestamp = static_cast<uint32_t>(n * 90000LL / options.fps);
+        for (auto& sender : senders) {
+            auto frame = sender->acquireFrame();
+            fill_frame(*frame, payload, payload_bytes, timestamp, n % options.fps == 0);
+            sender->enqueueFrame(std::move(frame));
+        }
+    }
+    // 等待队列发空
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    for (auto& sender : senders) {
+        while (sender->sendQueueStats().queued_frames > 0 && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+    const double elapsed_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    const double cpu_ms = process_cpu_ms() - cpu_start_ms;
+    rusage usage_end{};
+    getrusage(RUSAGE_SELF, &usage_end);
+
+    RtpSender::SendQueueStats total;
+    for (auto& sender : senders) {
+        const auto stats = sender->sendQueueStats();
+        total.sent_frames += stats.sent_frames;
+        total.dropped_frames += stats.dropped_frames;
+        total.sent_packets += stats.sent_packets;
+        total.send_calls += stats.send_calls;
+        total.stalls += stats.stalls;
+        total.zerocopy_frames += stats.zerocopy_frames;
+        total.zerocopy_copied += stats.zerocopy_copied;
+        sender->stop();
+    }
+
+    SinkTotals sink;
+    if (is_local) {
+        write(control[0], "q", 1);
+        read(control[0], &sink, sizeof(sink));
+        waitpid(sink_pid, nullptr, 0);
+    }
+
+    const double tick_user_ms = user_ms(usage_end) - user_ms(usage_start);
+    const double tick_system_ms = system_ms(usage_end) - system_ms(usage_start);
+    const size_t frame_bytes = payload_bytes + PS_HEADER_BYTES + PES_HEADER_BYTES;
+    const double sent_bytes = static_cast<double>(total.sent_frames) * static_cast<double>(frame_bytes);
+    const double sent_mbit = sent_bytes * 8 / 1e6;
+    const double frames = static_cast<double>(std::max<uint64_t>(1, total.sent_frames));
+
+    printf("\n%s batch=%d gso=%d io_uring=%d zerocopy=%d, %d session(s) x %.1f Mbit/s @ %d fps (%zu byte frames), "
+           "%d s, to %s\n", options.is_tcp ? "tcp" : "udp", RTP_UDP_BATCH, RTP_UDP_GSO, RTP_IO_URING,
+           RTP_TCP_ZEROCOPY, options.sessions, options.mbps, options.fps, frame_bytes, options.seconds,
+           is_local ? "loopback" : options.remote_host.c_str());
+    printf("frames      sent %llu, dropped %llu, stalls %llu\n", static_cast<unsigned long long>(total.sent_frames),
+           static_cast<unsigned long long>(total.dropped_frames), static_cast<unsigned long long>(total.stalls));
+    printf("packets     %llu (%.1f per frame), %.0f pps\n", static_cast<unsigned long long>(total.sent_packets),
+           static_cast<double>(total.sent_packets) / frames, static_cast<double>(total.sent_packets) / elapsed_s);
+    printf("syscalls    %llu (%.2f per frame)\n", static_cast<unsigned long long>(total.send_calls),
+           static_cast<double>(total.send_calls) / frames);
+    printf("cpu         %.1f ms (user:sys %.0f:%.0f), %.2f%% of one core, %.1f us per Mbit\n", cpu_ms, tick_user_ms,
+           tick_system_ms, cpu_ms / (elapsed_s * 10), cpu_ms * 1e3 / std::max(sent_mbit, 1e-9));
+    if (options.is_tcp) {
+        // 回退为拷贝的通知按发送调用计数，出现过即视为零拷贝未生效
+        const double zerocopy_bytes =
+                total.zerocopy_copied == 0 ? static_cast<double>(total.zerocopy_frames * frame_bytes) : 0;
+        printf("zerocopy    %llu frames sent with MSG_ZEROCOPY, %llu sends reported COPIED\n",
+               static_cast<unsigned long long>(total.zerocopy_frames),
+               static_cast<unsigned long long>(total.zerocopy_copied));
+        printf("kernel copy ~%.1f MB (%.1f MB/s)\n", (sent_bytes - zerocopy_bytes) / 1e6,
+               (sent_bytes - zerocopy_bytes) / 1e6 / elapsed_s);
+        if (RTP_TCP_ZEROCOPY && (total.zerocopy_frames == 0 || total.zerocopy_copied > 0)) {
+            const char* reason = total.zerocopy_frames == 0
+                                     ? "no frame reached RTP_TCP_ZEROCOPY_MIN_BYTES or SO_ZEROCOPY failed"
+                                     : "kernel copied, e.g. loopback or no NIC SG/checksum offload";
+            printf("NOTE        zerocopy did not take effect on this route (%s), "
+                   "this run does not measure its savings\n", reason);
+        }
+    }
+    if (!is_local) {
+        printf("sink        see the receiver's output\n");
+    } else if (options.is_tcp) {
+        printf("sink        %llu bytes\n", static_cast<unsigned long long>(sink.bytes));
+    } else {
+        printf("sink        %llu packets (%.2f%% lost)\n", static_cast<unsigned long long>(sink.packets),
+               total.sent_packets > 0
+                   ? 100.0 * (1.0 - static_cast<double>(sink.packets) / static_cast<double>(total.sent_packets))
+                   : 0.0);
+    }
+    return 0;
+}
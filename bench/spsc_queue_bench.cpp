@@ -0,0 +1,171 @@
+//
+// Created by pengx on 2026/10/16.
+//
+
+/**
+ * 采集 -> 编码 帧交接的微基准：SpscQueue（FIFO / LATEST）对比原来的互斥锁 + 条件变量环形队列
+ *
+ * 生产者按固定间隔写入带发送时刻的元素，消费者阻塞读取并记录交接时延（写入前 -> 读出后），
+ * 输出时延分位数、标准差（抖动）以及生产者单次写入耗时。
+ *
+ * 用法：spsc_queue_bench [元素个数，默认 20000] [写入间隔微秒，默认 200]
+ * */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "spsc_queue.hpp"
+
+namespace {
+int64_t now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * 原 FrameEncoder 的待编码队列：互斥锁保护的环形缓冲区，写入后 notify_one，满时按策略丢弃
+ */
+class LockedRing {
+public:
+    LockedRing(const size_t capacity, const bool drop_oldest)
+        : _frames(capacity), _capacity(capacity), _drop_oldest(drop_oldest) {}
+
+    void push(const int64_t item) {
+        std::unique_lock<std::mutex> lock(_mutex);
+        if (_count == _capacity) {
+            if (!_drop_oldest) {
+                return;
+            }
+            _read_index = (_read_index + 1) % _capacity;
+            _count--;
+        }
+        _frames[_write_index] = item;
+        _write_index = (_write_index + 1) % _capacity;
+        _count++;
+        _cv.notify_one();
+    }
+
+    bool waitPop(int64_t& item, const int timeout_ms) {
+        std::unique_lock<std::mutex> lock(_mutex);
+        if (!_cv.wait_for(lock, std::chrono::milliseconds(timeout_ms), [this] { return _count > 0; })) {
+            return false;
+        }
+        item = _frames[_read_index];
+        _read_index = (_read_index + 1) % _capacity;
+        _count--;
+        return true;
+    }
+
+private:
+    std::vector<int64_t> _frames;
+    const size_t _capacity;
+    const bool _drop_oldest;
+    size_t _write_index = 0;
+    size_t _read_index = 0;
+    size_t _count = 0;
+    std::mutex _mutex;
+    std::condition_variable _cv;
+};
+
+struct Result {
+    std::vector<int64_t> latency_ns;
+    std::vector<int64_t> push_ns;
+};
+
+template <typename Queue>
+Result run(Queue& queue, const int count, const int interval_us) {
+    Result result;
+    result.latency_ns.reserve(count);
+    result.push_ns.reserve(count);
+
+    std::thread consumer([&] {
+        int64_t item = 0;
+        while (true) {
+            if (!queue.waitPop(item, 100)) {
+                continue;
+            }
+            if (item < 0) {
+                break;
+            }
+            result.latency_ns.push_back(now_ns() - item);
+        }
+    });
+
+    auto next = std::chrono::steady_clock::now();
+    for (int i = 0; i < count; ++i) {
+        next += std::chrono::microseconds(interval_us);
+        std::this_thread::sleep_until(next);
+        const int64_t start = now_ns();
+        queue.push(start);
+        result.push_ns.push_back(now_ns() - start);
+    }
+    // 结束标记，等消费者取完之前的元素
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    queue.push(-1);
+    consumer.join();
+    return result;
+}
+
+void report(const char* name, Result& result) {
+    auto& latency = result.latency_ns;
+    auto& push = result.push_ns;
+    std::sort(latency.begin(), latency.end());
+    std::sort(push.begin(), push.end());
+    const auto percentile = [](const std::vector<int64_t>& values, const double p) {
+        return values.empty() ? 0.0 : values[std::min(values.size() - 1, static_cast<size_t>(p * values.size()))] / 1000.0;
+    };
+
+    double mean = 0;
+    for (const auto value : latency) {
+        mean += value;
+    }
+    mean /= std::max<size_t>(1, latency.size());
+    double variance = 0;
+    for (const auto value : latency) {
+        variance += (value - mean) * (value - mean);
+    }
+    const double stddev = std::sqrt(variance / std::max<size_t>(1, latency.size()));
+
+    printf("%-18s %8zu %8.1f %8.1f %8.1f %8.1f %8.1f | %8.2f %8.2f\n", name, latency.size(),
+           percentile(latency, 0.5), percentile(latency, 0.99), percentile(latency, 0.999),
+           latency.empty() ? 0.0 : latency.back() / 1000.0, stddev / 1000.0, percentile(push, 0.5),
+           percentile(push, 0.99));
+}
+} // namespace
+
+int main(const int argc, char** argv) {
+    const int count = argc > 1 ? atoi(argv[1]) : 20000;
+    const int interval_us = argc > 2 ? atoi(argv[2]) : 200;
+    printf("items: %d, interval: %d us\n", count, interval_us);
+    printf("%-18s %8s %8s %8s %8s %8s %8s | %8s %8s\n", "queue", "samples", "p50 us", "p99 us", "p99.9 us",
+           "max us", "jitter", "push p50", "push p99");
+
+    {
+        LockedRing queue(3, false);
+        auto result = run(queue, count, interval_us);
+        report("mutex FIFO", result);
+    }
+    {
+        LockedRing queue(3, true);
+        auto result = run(queue, count, interval_us);
+        report("mutex drop-oldest", result);
+    }
+    {
+        SpscQueue<int64_t> queue(3, SpscQueue<int64_t>::Mode::FIFO);
+        auto result = run(queue, count, interval_us);
+        report("spsc FIFO", result);
+    }
+    {
+        SpscQueue<int64_t> queue(3, SpscQueue<int64_t>::Mode::LATEST);
+        auto result = run(queue, count, interval_us);
+        report("spsc LATEST", result);
+    }
+    return 0;
+}
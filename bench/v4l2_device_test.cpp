@@ -0,0 +1,240 @@
+//
+// Created by pengx on 2026/10/16.
+//
+
+/**
+ * V4l2Device 出队校验测试：用模拟的 ioctl 层代替真实驱动
+ *
+ * 本程序定义的 open / ioctl 覆盖 libc 的同名函数（只接管 FAKE_DEVICE 路径），设备 fd 为 memfd，
+ * V4l2Device 照常 mmap 驱动缓冲区。模拟驱动按脚本依次出帧（bytesused、flags），检查：
+ * 1. 完整帧正常交给调用方；sizeimage 带对齐填充时，bytesused 只需覆盖实际图像数据
+ * 2. 带 V4L2_BUF_FLAG_ERROR、数据不完整、空的缓冲区被丢弃、计数，并立即归还驱动（驱动队列不被耗尽）
+ *
+ * 用法：v4l2_device_test，全部通过返回 0
+ * */
+
+#include <dlfcn.h>
+#include <fcntl.h>
+#include <linux/videodev2.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <vector>
+
+#include "v4l2_device.hpp"
+
+namespace {
+constexpr const char* FAKE_DEVICE = "/dev/fake-video0";
+constexpr uint32_t PAGE_SIZE_BYTES = 4096;
+
+struct ScriptedFrame {
+    uint32_t bytes_used;
+    uint32_t flags;
+};
+
+/**
+ * 模拟驱动状态
+ */
+struct FakeDriver {
+    int fd = -1;
+    uint32_t width = 0;
+    uint32_t height = 0;
+    uint32_t pixel_format = 0;
+    uint32_t size_padding = 0; // sizeimage 在图像数据之外的对齐填充
+    uint32_t buffer_count = 0;
+    std::deque<uint32_t> queued{}; // 驱动持有的（已 QBUF）缓冲区
+    std::deque<ScriptedFrame> script{};
+    uint32_t sequence = 0;
+
+    uint32_t bytesPerLine() const {
+        return pixel_format == V4L2_PIX_FMT_YUYV ? width * 2 : width;
+    }
+
+    uint32_t imageSize() const {
+        const uint32_t plane = bytesPerLine() * height;
+        return pixel_format == V4L2_PIX_FMT_YUYV ? plane : plane * 3 / 2;
+    }
+
+    uint32_t sizeImage() const {
+        return imageSize() + size_padding;
+    }
+
+    uint32_t bufferLength() const {
+        return (sizeImage() + PAGE_SIZE_BYTES - 1) / PAGE_SIZE_BYTES * PAGE_SIZE_BYTES;
+    }
+};
+
+FakeDriver driver;
+
+int fake_ioctl(const unsigned long request, void* arg) {
+    switch (request) {
+    case VIDIOC_QUERYCAP: {
+        auto* cap = static_cast<v4l2_capability*>(arg);
+        cap->capabilities = V4L2_CAP_VIDEO_CAPTURE | V4L2_CAP_STREAMING;
+        return 0;
+    }
+    case VIDIOC_S_FMT: {
+        auto* fmt = static_cast<v4l2_format*>(arg);
+        driver.width = fmt->fmt.pix.width;
+        driver.height = fmt->fmt.pix.height;
+        driver.pixel_format = fmt->fmt.pix.pixelformat;
+        fmt->fmt.pix.bytesperline = driver.bytesPerLine();
+        fmt->fmt.pix.sizeimage = driver.sizeImage();
+        return 0;
+    }
+    case VIDIOC_S_PARM:
+    case VIDIOC_STREAMON:
+    case VIDIOC_STREAMOFF:
+        return 0;
+    case VIDIOC_REQBUFS: {
+        auto* req = static_cast<v4l2_requestbuffers*>(arg);
+        driver.buffer_count = req->count;
+        driver.queued.clear();
+        if (req->count > 0 && ftruncate(driver.fd, static_cast<off_t>(req->count) * driver.bufferLength()) < 0) {
+            return -1;
+        }
+        return 0;
+    }
+    case VIDIOC_QUERYBUF: {
+        auto* buf = static_cast<v4l2_buffer*>(arg);
+        buf->length = driver.bufferLength();
+        buf->m.offset = buf->index * driver.bufferLength();
+        return 0;
+    }
+    case VIDIOC_QBUF: {
+        const auto* buf = static_cast<v4l2_buffer*>(arg);
+        if (buf->index >= driver.buffer_count) {
+            errno = EINVAL;
+            return -1;
+        }
+        driver.queued.push_back(buf->index);
+        return 0;
+    }
+    case VIDIOC_DQBUF: {
+        if (driver.queued.empty() || driver.script.empty()) {
+            errno = EAGAIN;
+            return -1;
+        }
+        auto* buf = static_cast<v4l2_buffer*>(arg);
+        buf->index = driver.queued.front();
+        driver.queued.pop_front();
+        buf->bytesused = driver.script.front().bytes_used;
+        buf->flags = driver.script.front().flags | V4L2_BUF_FLAG_TIMESTAMP_MONOTONIC;
+        buf->sequence = driver.sequence++;
+        driver.script.pop_front();
+        return 0;
+    }
+    default:
+        errno = ENOTTY;
+        return -1;
+    }
+}
+
+int failures = 0;
+
+void expect(const bool condition, const char* what) {
+    if (!condition) {
+        printf("FAILED: %s\n", what);
+        ++failures;
+    }
+}
+
+/**
+ * 跑完脚本，返回交给调用方的帧序号；取到的帧立即归还，和采集线程的用法一致
+ */
+std::vector<uint32_t> drain(V4l2Device& device) {
+    std::vector<uint32_t> sequences;
+    while (!driver.script.empty()) {
+        V4l2Device::Buffer buffer;
+        if (device.dequeue(buffer)) {
+            sequences.push_back(buffer.sequence);
+            device.enqueue(buffer.index);
+        }
+    }
+    return sequences;
+}
+
+void test_format(const uint32_t pixel_format, const uint32_t size_padding, const char* name) {
+    driver = FakeDriver();
+    driver.size_padding = size_padding;
+    V4l2Device device(FAKE_DEVICE);
+    if (!device.open(64, 48, 25, pixel_format, 4) || !device.startStreaming()) {
+        printf("FAILED: %s: open\n", name);
+        ++failures;
+        return;
+    }
+
+    const uint32_t image = driver.imageSize();
+    driver.script = {
+        {image, 0},                      // 0 完整
+        {image / 2, 0},                  // 1 不完整
+        {image, V4L2_BUF_FLAG_ERROR},    // 2 驱动标记出错
+        {0, 0},                          // 3 空
+        {image - 1, 0},                  // 4 差一个字节
+        {driver.sizeImage(), 0},         // 5 含填充的整个 sizeimage
+        {image, 0},                      // 6 完整
+    };
+    // 被丢弃的帧若没有归还，4 个驱动缓冲区会在脚本跑完前耗尽，drain 不会结束
+    const auto sequences = drain(device);
+
+    printf("%-24s accepted:", name);
+    for (const uint32_t sequence : sequences) {
+        printf(" %u", sequence);
+    }
+    printf(", rejected %llu, buffers back in driver %zu/%u\n",
+           static_cast<unsigned long long>(device.rejectedFrames()), driver.queued.size(), driver.buffer_count);
+
+    expect(sequences == std::vector<uint32_t>({0, 5, 6}), "only complete frames are handed out");
+    expect(device.rejectedFrames() == 4, "corrupted and incomplete frames are counted");
+    expect(driver.queued.size() == driver.buffer_count, "rejected buffers are re-queued");
+    device.close();
+}
+} // namespace
+
+extern "C" {
+/**
+ * 覆盖 libc 的 open / ioctl：模拟设备路径走模拟驱动，其余转发给 libc
+ */
+int open(const char* path, const int flags, ...) {
+    if (strcmp(path, FAKE_DEVICE) == 0) {
+        driver.fd = memfd_create("fake-video", 0);
+        return driver.fd;
+    }
+    mode_t mode = 0;
+    if (flags & O_CREAT) {
+        va_list args;
+        va_start(args, flags);
+        mode = va_arg(args, mode_t);
+        va_end(args);
+    }
+    using OpenFunction = int (*)(const char*, int, ...);
+    static const auto libc_open = reinterpret_cast<OpenFunction>(dlsym(RTLD_NEXT, "open"));
+    return libc_open(path, flags, mode);
+}
+
+int ioctl(const int fd, const unsigned long request, ...) {
+    va_list args;
+    va_start(args, request);
+    void* arg = va_arg(args, void*);
+    va_end(args);
+    if (fd >= 0 && fd == driver.fd) {
+        return fake_ioctl(request, arg);
+    }
+    using IoctlFunction = int (*)(int, unsigned long, ...);
+    static const auto libc_ioctl = reinterpret_cast<IoctlFunction>(dlsym(RTLD_NEXT, "ioctl"));
+    return libc_ioctl(fd, request, arg);
+}
+}
+
+int main() {
+    test_format(V4L2_PIX_FMT_YUYV, 0, "YUYV");
+    test_format(V4L2_PIX_FMT_NV12, 0, "NV12");
+    test_format(V4L2_PIX_FMT_YUV420, PAGE_SIZE_BYTES / 2, "I420 padded sizeimage");
+    printf("%s\n", failures == 0 ? "OK" : "FAILED");
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,172 @@
+//
+// Created by pengx on 2026/10/16.
+//
+
+#include "io_uring.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <ctime>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+IoUring::IoUring() : _logger("IoUring") {
+    _logger.i("IoUring created");
+}
+
+IoUring::~IoUring() {
+    release();
+}
+
+bool IoUring::init(const unsigned entries, const unsigned required_features) {
+    release();
+
+    io_uring_params params{};
+    const int fd = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+    if (fd < 0) {
+        _logger.wFmt("io_uring_setup failed: %d (%s)", errno, strerror(errno));
+        return false;
+    }
+    _ring_fd = fd;
+    if ((params.features & required_features) != required_features) {
+        _logger.wFmt("io_uring features 0x%x missing required 0x%x", params.features, required_features);
+        release();
+        return false;
+    }
+
+    _sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    _cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    const bool is_single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (is_single_mmap) {
+        _sq_ring_size = _cq_ring_size = std::max(_sq_ring_size, _cq_ring_size);
+    }
+
+    _sq_ring_ptr = mmap(nullptr, _sq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd,
+                        IORING_OFF_SQ_RING);
+    if (_sq_ring_ptr == MAP_FAILED) {
+        _sq_ring_ptr = nullptr;
+        _logger.eFmt("mmap io_uring SQ ring failed: %d", errno);
+        release();
+        return false;
+    }
+    if (is_single_mmap) {
+        _cq_ring_ptr = _sq_ring_ptr;
+    } else {
+        _cq_ring_ptr = mmap(nullptr, _cq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd,
+                            IORING_OFF_CQ_RING);
+        if (_cq_ring_ptr == MAP_FAILED) {
+            _cq_ring_ptr = nullptr;
+            _logger.eFmt("mmap io_uring CQ ring failed: %d", errno);
+            release();
+            return false;
+        }
+    }
+    _sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+    void* sqes = mmap(nullptr, _sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+    if (sqes == MAP_FAILED) {
+        _logger.eFmt("mmap io_uring SQEs failed: %d", errno);
+        release();
+        return false;
+    }
+    _sqes = static_cast<io_uring_sqe*>(sqes);
+
+    auto* sq = static_cast<uint8_t*>(_sq_ring_ptr);
+    _sq_head = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+    _sq_tail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+    _sq_mask = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+    _sq_array = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+    _sq_entries = params.sq_entries;
+    _sqe_head = _sqe_tail = *_sq_tail;
+
+    auto* cq = static_cast<uint8_t*>(_cq_ring_ptr);
+    _cq_head = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+    _cq_tail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+    _cq_mask = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+    _cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+
+    _logger.iFmt("io_uring ready, sq entries: %u, cq entries: %u, features: 0x%x", params.sq_entries,
+                 params.cq_entries, params.features);
+    return true;
+}
+
+void IoUring::release() {
+    if (_sqes) {
+        munmap(_sqes, _sqes_size);
+        _sqes = nullptr;
+    }
+    if (_cq_ring_ptr && _cq_ring_ptr != _sq_ring_ptr) {
+        munmap(_cq_ring_ptr, _cq_ring_size);
+    }
+    _cq_ring_ptr = nullptr;
+    if (_sq_ring_ptr) {
+        munmap(_sq_ring_ptr, _sq_ring_size);
+        _sq_ring_ptr = nullptr;
+    }
+    if (_ring_fd >= 0) {
+        close(_ring_fd);
+        _ring_fd = -1;
+    }
+    _sq_entries = 0;
+}
+
+bool IoUring::registerFiles(const int* fds, const unsigned count) {
+    if (syscall(__NR_io_uring_register, _ring_fd, IORING_REGISTER_FILES, fds, count) < 0) {
+        _logger.wFmt("io_uring register files failed: %d (%s)", errno, strerror(errno));
+        return false;
+    }
+    return true;
+}
+
+io_uring_sqe* IoUring::getSqe() {
+    const unsigned head = __atomic_load_n(_sq_head, __ATOMIC_ACQUIRE);
+    if (_sqe_tail - head >= _sq_entries) {
+        return nullptr;
+    }
+    io_uring_sqe* sqe = &_sqes[_sqe_tail & _sq_mask];
+    ++_sqe_tail;
+    memset(sqe, 0, sizeof(*sqe));
+    return sqe;
+}
+
+int IoUring::submit(const unsigned wait_nr, const int timeout_ms) {
+    // 把已填充的 SQE 放入 SQ，tail 以 release 语义发布给内核
+    unsigned tail = *_sq_tail;
+    const unsigned to_submit = _sqe_tail - _sqe_head;
+    for (; _sqe_head != _sqe_tail; ++_sqe_head, ++tail) {
+        _sq_array[tail & _sq_mask] = _sqe_head & _sq_mask;
+    }
+    __atomic_store_n(_sq_tail, tail, __ATOMIC_RELEASE);
+
+    unsigned flags = wait_nr > 0 ? IORING_ENTER_GETEVENTS : 0;
+    const void* arg = nullptr;
+    size_t arg_size = 0;
+    __kernel_timespec ts{};
+    io_uring_getevents_arg getevents_arg{};
+    if (wait_nr > 0 && timeout_ms >= 0) {
+        // 需要 IORING_FEAT_EXT_ARG（内核 5.11+）
+        ts.tv_sec = timeout_ms / 1000;
+        ts.tv_nsec = static_cast<long long>(timeout_ms % 1000) * 1000000;
+        getevents_arg.sigmask_sz = _NSIG / 8;
+        getevents_arg.ts = reinterpret_cast<uint64_t>(&ts);
+        flags |= IORING_ENTER_EXT_ARG;
+        arg = &getevents_arg;
+        arg_size = sizeof(getevents_arg);
+    }
+
+    const int ret = static_cast<int>(syscall(__NR_io_uring_enter, _ring_fd, to_submit, wait_nr, flags, arg,
+                                             arg_size));
+    return ret < 0 ? -errno : ret;
+}
+
+bool IoUring::peekCqe(io_uring_cqe& cqe) {
+    const unsigned head = *_cq_head;
+    if (head == __atomic_load_n(_cq_tail, __ATOMIC_ACQUIRE)) {
+        return false;
+    }
+    cqe = _cqes[head & _cq_mask];
+    __atomic_store_n(_cq_head, head + 1, __ATOMIC_RELEASE);
+    return true;
+}
@@ -0,0 +1,103 @@
+//
+// Created by pengx on 2026/10/16.
+//
+
+#ifndef GB28181CONSOLE_IO_URING_HPP
+#define GB28181CONSOLE_IO_URING_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <linux/io_uring.h>
+
+#include "logger.hpp"
+
+/**
+ * io_uring 的最小封装（直接使用系统调用，不依赖 liburing）
+ *
+ * 只由一个线程使用：getSqe() 取 SQE 并填充，submit() 一次系统调用提交所有已填充的 SQE（可同时等待完成事件），
+ * peekCqe() 逐个取出完成事件。内核不支持（或被禁用）时 init() 返回 false，由调用方回退到普通系统调用。
+ * */
+class IoUring {
+public:
+    explicit IoUring();
+
+    ~IoUring();
+
+    IoUring(const IoUring&) = delete;
+
+    IoUring& operator=(const IoUring&) = delete;
+
+    /**
+     * 创建 ring 并映射 SQ/CQ
+     *
+     * @param entries SQ 长度（CQ 为其两倍）
+     * @param required_features 必需的 IORING_FEAT_* 特性，内核缺少时视为不可用
+     */
+    bool init(unsigned entries, unsigned required_features);
+
+    void release();
+
+    bool isOpen() const {
+        return _ring_fd >= 0;
+    }
+
+    unsigned sqEntries() const {
+        return _sq_entries;
+    }
+
+    /**
+     * 注册固定文件，之后 SQE 使用 IOSQE_FIXED_FILE 并以下标代替 fd，省去每次请求查找/引用文件
+     */
+    bool registerFiles(const int* fds, unsigned count);
+
+    /**
+     * 取一个已清零的空闲 SQE，SQ 已满时返回 nullptr
+     */
+    io_uring_sqe* getSqe();
+
+    /**
+     * 提交所有已填充的 SQE，并等待至少 wait_nr 个完成事件
+     *
+     * @param timeout_ms 等待超时，-1 表示不超时
+     * @return 提交的 SQE 个数，失败返回 -errno（超时为 -ETIME）
+     */
+    int submit(unsigned wait_nr, int timeout_ms = -1);
+
+    /**
+     * 取出一个完成事件
+     *
+     * @return 没有完成事件时返回 false
+     */
+    bool peekCqe(io_uring_cqe& cqe);
+
+private:
+    Logger _logger;
+
+    int _ring_fd = -1;
+    unsigned _sq_entries = 0;
+
+    // mmap 区域
+    void* _sq_ring_ptr = nullptr;
+    size_t _sq_ring_size = 0;
+    void* _cq_ring_ptr = nullptr;
+    size_t _cq_ring_size = 0;
+    io_uring_sqe* _sqes = nullptr;
+    size_t _sqes_size = 0;
+
+    // SQ：内核消费 head，本线程推进 tail
+    unsigned* _sq_head = nullptr;
+    unsigned* _sq_tail = nullptr;
+    unsigned _sq_mask = 0;
+    unsigned* _sq_array = nullptr;
+    // 已取出但尚未放入 SQ 的 SQE 范围 [_sqe_head, _sqe_tail)
+    unsigned _sqe_head = 0;
+    unsigned _sqe_tail = 0;
+
+    // CQ：内核推进 tail，本线程消费 head
+    unsigned* _cq_head = nullptr;
+    unsigned* _cq_tail = nullptr;
+    unsigned _cq_mask = 0;
+    io_uring_cqe* _cqes = nullptr;
+};
+
+#endif //GB28181CONSOLE_IO_URING_HPP
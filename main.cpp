@@ -7,21 +7,24 @@
 #include "frame_capture.hpp"
 #include "logger.hpp"
 #include "ps_muxer.hpp"
+#include "rtp_sender.hpp"
 #include "sip_manager.hpp"
+#include "video/bitrate_controller.hpp"
 #include "video/frame_encoder.hpp"
-
-static constexpr int TIMESTAMP_BASE = 90000; // 90kHz
+#include "video/video_profile.hpp"
 
 static std::unique_ptr<Logger> logger_ptr = nullptr;
-static std::unique_ptr<FrameEncoder> frame_encoder_ptr = nullptr;
+// 每个编码档位（主/子码流）一个编码器，共用同一路采集
+static std::vector<std::unique_ptr<FrameEncoder>> frame_encoders;
 static std::unique_ptr<FrameCapture> frame_capture_ptr = nullptr;
+// 根据上行拥塞情况调整当前推送档位的码率
+static std::unique_ptr<BitrateController> bitrate_controller_ptr = nullptr;
 static std::unique_ptr<SipManager> sip_manager_ptr = nullptr;
 
 static std::atomic<bool> is_app_running{true};
 static std::atomic<bool> is_registered{false};
 static std::atomic<bool> is_push_stream{false};
 static std::atomic<bool> is_audio_talking{false};
-static std::atomic<uint32_t> frame_count{0};
 
 static std::mutex exit_mutex;
 static std::condition_variable exit_cv;
@@ -48,24 +51,33 @@ void cleanup() {
 
     is_push_stream = false;
 
+    if (bitrate_controller_ptr) {
+        logger_ptr->i("Stopping bitrate controller...");
+        bitrate_controller_ptr->stop();
+    }
+
     if (sip_manager_ptr) {
         logger_ptr->i("Stopping SIP manager...");
         sip_manager_ptr->logout();
         sip_manager_ptr->shutdown();
     }
 
+    // 先停采集线程，再释放编码器（归还它持有的池帧），最后销毁采集器及其缓冲池
     if (frame_capture_ptr) {
         logger_ptr->i("Stopping frame capture...");
         frame_capture_ptr->stop();
-        frame_capture_ptr.reset();
     }
 
-    if (frame_encoder_ptr) {
-        logger_ptr->i("Stopping frame encoder...");
-        frame_encoder_ptr->stop();
-        frame_encoder_ptr.reset();
+    if (!frame_encoders.empty()) {
+        logger_ptr->i("Stopping frame encoders...");
+        for (auto& encoder : frame_encoders) {
+            encoder->stop();
+        }
+        frame_encoders.clear();
     }
 
+    frame_capture_ptr.reset();
+
     logger_ptr->i("Releasing PS muxer...");
     PsMuxer::get()->release();
 
@@ -113,6 +125,23 @@ static void stop_audio_talk() {
 // ============================================================
 // SIP管理
 // ============================================================
+/**
+ * 有拉流会话时只唤醒平台点播的档位，其余档位处于空闲状态：编码器上下文保持打开，但不转换、不编码，恢复时第一帧强制 IDR
+ *
+ * 无会话时 GOP_CACHE_WHILE_IDLE 开启则上一次点播的档位继续编码，PsMuxer 始终持有其当前 GOP；
+ * 关闭时所有编码器与采集都空闲
+ */
+static void set_encoding_active(const bool is_active) {
+    const bool is_warm = is_active || GOP_CACHE_WHILE_IDLE;
+    const int selected = VideoProfiles::get()->selected();
+    for (size_t i = 0; i < frame_encoders.size(); ++i) {
+        frame_encoders[i]->setActive(is_warm && static_cast<int>(i) == selected);
+    }
+    if (frame_capture_ptr) {
+        frame_capture_ptr->setIdle(!is_warm);
+    }
+}
+
 static void handle_sip_message(const int code, const std::string& message) {
     logger_ptr->dBox().addFmt("响应码：%d", code).add(message).print();
     if (code == 1000) {
@@ -121,12 +150,45 @@ static void handle_sip_message(const int code, const std::string& message) {
     } else if (code == 201) {
         // 注销成功
         is_registered = false;
+    } else if (code == 2110) {
+        // 收到点播请求：被点播的档位空闲期间一直在编码时，PsMuxer 缓存的就是它的当前 GOP，会话建立后直接回放；
+        // 否则唤醒该档位（恢复时编码器自行请求 IDR），INVITE 处理期间产出的 GOP 先缓存在 PsMuxer
+        const int selected = VideoProfiles::get()->selected();
+        const VideoCodec codec = VideoProfiles::get()->selectedCodec();
+        const bool is_warm = frame_encoders[selected]->isActive();
+        const bool has_gop = PsMuxer::get()->prepareSession(codec, is_warm);
+        frame_encoders[selected]->setCodec(codec);
+        set_encoding_active(true);
+        if (is_warm && !has_gop) {
+            // 编码器一直在运行，唤醒不会产生 IDR
+            frame_encoders[selected]->requestKeyFrame();
+        }
+    } else if (code == 2111) {
+        // 平台请求关键帧（编码器内部限频）
+        if (is_push_stream) {
+            frame_encoders[VideoProfiles::get()->selected()]->requestKeyFrame();
+        }
+    } else if (code == 2103 || code == 2109) {
+        // 点播失败，回到空闲
+        set_encoding_active(false);
+        PsMuxer::get()->release();
     } else if (code == 2100) {
-        // 开始推流
+        // 开始推流，各档位恢复标称码率，由码率控制器从当前档位重新开始调整
+        for (auto& encoder : frame_encoders) {
+            encoder->setBitRate(encoder->profile().bit_rate);
+        }
+        bitrate_controller_ptr->reset(VideoProfiles::get()->profiles()[VideoProfiles::get()->selected()].bit_rate);
         is_push_stream = true;
+        set_encoding_active(true);
+        if (PsMuxer::get()->startSession()) {
+            // 只回放了陈旧 GOP 的 IDR，实时帧需要新的 IDR 才能解码
+            frame_encoders[VideoProfiles::get()->selected()]->requestKeyFrame();
+        }
     } else if (code == 2101) {
-        // 停止推流
+        // 停止推流，下次会话重新等待IDR并重置时钟零点
         is_push_stream = false;
+        set_encoding_active(false);
+        PsMuxer::get()->release();
     } else if (code == 2200) {
         // 开始播放对讲语音
         if (is_audio_talking) {
@@ -191,36 +253,50 @@ int main() {
     signal(SIGTERM, signal_handler);
     logger_ptr = std::make_unique<Logger>("main");
 
-    frame_encoder_ptr = std::make_unique<FrameEncoder>(VIDEO_FPS);
-    frame_encoder_ptr->start([](const std::vector<uint8_t>& h264) {
-        if (h264.empty()) {
-            return;
-        }
-        if (is_push_stream.load()) {
-            // 计算 90kHz 时间戳（固定帧率）
-            // 每帧间隔 = 90000 / 25 = 3600
-            const uint32_t pts_90k = frame_count * (TIMESTAMP_BASE / VIDEO_FPS);
+    const auto& profiles = VideoProfiles::get()->profiles();
+    for (size_t i = 0; i < profiles.size(); ++i) {
+        auto encoder = std::make_unique<FrameEncoder>(profiles[i], VIDEO_FPS);
+        const int profile_index = static_cast<int>(i);
+        encoder->start([profile_index](const EncodedPacketPtr& packet) {
+            // 只推送平台点播的档位；会话建立前 PsMuxer 只缓存当前 GOP，建立后才发送
+            if (VideoProfiles::get()->selected() == profile_index) {
+                // 90kHz 时间戳由 PsMuxer 根据采集时间戳推导
+                PsMuxer::get()->writeVideoFrame(packet);
+            }
+        });
+        frame_encoders.push_back(std::move(encoder));
+    }
+    logger_ptr->iFmt("%zu frame encoders started", frame_encoders.size());
+
+    bitrate_controller_ptr = std::make_unique<BitrateController>();
+    bitrate_controller_ptr->setCallback([](const int64_t bit_rate) {
+        frame_encoders[VideoProfiles::get()->selected()]->setBitRate(bit_rate);
+    });
+    bitrate_controller_ptr->start();
 
-            PsMuxer::get()->writeVideoFrame(h264.data(), pts_90k, h264.size());
-            frame_count.fetch_add(1, std::memory_order_relaxed);
+    // 发送队列溢出丢掉了参考帧，后续 P 帧无法解码，请求 IDR 重新同步
+    RtpSender::get()->setKeyFrameRequestCallback([] {
+        if (is_push_stream) {
+            frame_encoders[VideoProfiles::get()->selected()]->requestKeyFrame();
         }
     });
-    logger_ptr->i("Frame encoder started");
 
-    // 摄像头采集
+    // 摄像头采集，同一帧以引用方式分发给所有档位的编码器；启动时没有拉流会话，先进入空闲状态
     frame_capture_ptr = std::make_unique<FrameCapture>(0);
-    frame_capture_ptr->setCameraCallback([](const cv::Mat& frame) {
-        if (frame_encoder_ptr) {
-            frame_encoder_ptr->pushFrame(frame);
+    set_encoding_active(false);
+    frame_capture_ptr->setCameraCallback([](const FrameRef& frame) {
+        for (auto& encoder : frame_encoders) {
+            encoder->pushFrame(frame);
         }
     });
     if (!frame_capture_ptr->start()) {
         logger_ptr->e("Cannot open camera, application exit");
-        if (frame_encoder_ptr) {
-            logger_ptr->i("Stopping frame encoder...");
-            frame_encoder_ptr->stop();
-            frame_encoder_ptr.reset();
+        bitrate_controller_ptr->stop();
+        logger_ptr->i("Stopping frame encoders...");
+        for (auto& encoder : frame_encoders) {
+            encoder->stop();
         }
+        frame_encoders.clear();
         return 0;
     }
     logger_ptr->i("Camera capturing started");
@@ -4,6 +4,8 @@
 
 #include "rtp_sender.hpp"
 
+#include <algorithm>
+#include <chrono>
 #include <cstdio>
 #include <cstring>
 #include <fcntl.h>
@@ -11,32 +13,59 @@
 #include <random>
 #include <thread>
 #include <unistd.h>
+#include <poll.h>
 #include <arpa/inet.h>
+#include <linux/errqueue.h>
+#include <linux/sockios.h>
 #include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <netinet/udp.h>
+#include <sys/epoll.h>
+#include <sys/ioctl.h>
 #include <sys/socket.h>
 
 #include "utils.hpp"
+#include "video/copy_stats.hpp"
+
+#ifndef UDP_SEGMENT
+#define UDP_SEGMENT 103 // linux/udp.h，内核 4.18 起支持
+#endif
+
+#ifndef SO_ZEROCOPY
+#define SO_ZEROCOPY 60 // asm-generic/socket.h，内核 4.14 起支持
+#endif
+
+#ifndef MSG_ZEROCOPY
+#define MSG_ZEROCOPY 0x4000000
+#endif
+
+namespace {
+/**
+ * 两个零拷贝通知序号区间 [a, a + a_count)、[b, b + b_count) 的重叠个数，序号按 32 位回绕
+ */
+uint32_t zerocopy_id_overlap(const uint32_t a, const uint32_t a_count, const uint32_t b, const uint32_t b_count) {
+    const uint32_t b_offset = b - a;
+    if (b_offset < a_count) {
+        return std::min(a_count - b_offset, b_count);
+    }
+    const uint32_t a_offset = a - b;
+    if (a_offset < b_count) {
+        return std::min(b_count - a_offset, a_count);
+    }
+    return 0;
+}
+} // namespace
 
 RtpSender::RtpSender() : _logger("RtpSender") {
     _logger.i("RtpSender created");
 }
 
 bool RtpSender::initTcpSocket(const SdpStruct& sdp) {
-    auto cleanup_socket = [&]() {
-        if (_rtp_socket >= 0) {
-            close(_rtp_socket);
-            _rtp_socket = -1;
-        }
-    };
-
-    // 如果已有socket，先关闭
-    if (_rtp_socket > 0) {
-        cleanup_socket();
-    }
+    // 如果已有socket，先停止发送线程并关闭
+    stop();
 
     // 创建 TCP socket
-    _rtp_socket = socket(AF_INET, SOCK_STREAM, 0);
-    if (_rtp_socket < 0) {
+    if (!open_socket(true)) {
         _logger.e("创建 TCP socket 失败");
         return false;
     }
@@ -45,7 +74,7 @@ bool RtpSender::initTcpSocket(const SdpStruct& sdp) {
     int flags = fcntl(_rtp_socket, F_GETFL, 0);
     if (flags == -1 || fcntl(_rtp_socket, F_SETFL, flags | O_NONBLOCK) == -1) {
         _logger.e("设置 socket 为非阻塞模式失败");
-        cleanup_socket();
+        close_socket();
         return false;
     }
 
@@ -55,7 +84,7 @@ bool RtpSender::initTcpSocket(const SdpStruct& sdp) {
     remote_addr.sin_port = htons(sdp.remote_port);
     if (inet_pton(AF_INET, sdp.remote_host.c_str(), &remote_addr.sin_addr) <= 0) {
         _logger.eFmt("无效的目标主机地址: %s", sdp.remote_host.c_str());
-        cleanup_socket();
+        close_socket();
         return false;
     }
 
@@ -64,7 +93,7 @@ bool RtpSender::initTcpSocket(const SdpStruct& sdp) {
     if (ret < 0) {
         if (errno != EINPROGRESS) {
             _logger.eFmt("连接到 %s:%d 失败，错误代码: %d", sdp.remote_host.c_str(), sdp.remote_port,errno);
-            cleanup_socket();
+            close_socket();
             return false;
         }
 
@@ -80,7 +109,7 @@ bool RtpSender::initTcpSocket(const SdpStruct& sdp) {
         ret = select(_rtp_socket + 1, nullptr, &write_fds, nullptr, &timeout);
         if (ret <= 0) {
             _logger.eFmt("连接超时或失败：%s:%d", sdp.remote_host.c_str(), sdp.remote_port);
-            cleanup_socket();
+            close_socket();
             return false;
         }
 
@@ -89,36 +118,53 @@ bool RtpSender::initTcpSocket(const SdpStruct& sdp) {
         socklen_t len = sizeof(error);
         if (getsockopt(_rtp_socket, SOL_SOCKET, SO_ERROR, &error, &len) < 0 || error != 0) {
             _logger.eFmt("连接失败，socket错误: %d", error);
-            cleanup_socket();
+            close_socket();
             return false;
         }
     }
 
+    // 内核中未发出的数据超过阈值时 socket 不可写，发送线程据此等待，排队时延留在用户态队列中（可按 GOP 丢帧）
+    constexpr int not_sent_lowat = RTP_TCP_NOTSENT_LOWAT;
+    if (setsockopt(_rtp_socket, IPPROTO_TCP, TCP_NOTSENT_LOWAT, &not_sent_lowat, sizeof(not_sent_lowat)) < 0) {
+        _logger.wFmt("设置 TCP_NOTSENT_LOWAT 失败: %d", errno);
+    }
+
+    // 帧内的 RTP 包用 MSG_MORE 合并为满报文段，帧尾不再等待 Nagle，立即发出
+    constexpr int no_delay = 1;
+    if (setsockopt(_rtp_socket, IPPROTO_TCP, TCP_NODELAY, &no_delay, sizeof(no_delay)) < 0) {
+        _logger.wFmt("设置 TCP_NODELAY 失败: %d", errno);
+    }
+
+    // 大帧零拷贝发送：内核直接引用负载页面，发送完成后经错误队列通知（内核 4.14+）
+    _is_zerocopy_enabled = false;
+    _zerocopy_next_id = 0;
+    if (RTP_TCP_ZEROCOPY) {
+        constexpr int zerocopy = 1;
+        if (setsockopt(_rtp_socket, SOL_SOCKET, SO_ZEROCOPY, &zerocopy, sizeof(zerocopy)) == 0) {
+            _is_zerocopy_enabled = true;
+        } else {
+            _logger.wFmt("设置 SO_ZEROCOPY 失败: %d", errno);
+        }
+    }
+
     init_ssrc_seq(sdp.ssrc);
-    _is_tcp = true;
+    start_sender();
     _logger.dBox()
            .add("成功连接")
            .addFmt("目标地址: %s:%d", sdp.remote_host.c_str(), sdp.remote_port)
+           .addFmt("分帧方式: %s", RTP_TCP_FRAMING_RFC4571 ? "RFC 4571" : "RTSP interleaved")
+           .addFmt("零拷贝发送: %s（不小于 %d 字节的帧）", _is_zerocopy_enabled ? "开启" : "关闭",
+                   RTP_TCP_ZEROCOPY_MIN_BYTES)
            .print();
     return true;
 }
 
 bool RtpSender::initUdpSocket(const SdpStruct& sdp) {
-    auto cleanup_socket = [&]() {
-        if (_rtp_socket >= 0) {
-            close(_rtp_socket);
-            _rtp_socket = -1;
-        }
-    };
-
-    // 如果已有socket，先关闭
-    if (_rtp_socket > 0) {
-        cleanup_socket();
-    }
+    // 如果已有socket，先停止发送线程并关闭
+    stop();
 
     // 创建 UDP socket
-    _rtp_socket = socket(AF_INET, SOCK_DGRAM, 0);
-    if (_rtp_socket < 0) {
+    if (!open_socket(false)) {
         _logger.e("创建 UDP socket 失败");
         return false;
     }
@@ -127,7 +173,7 @@ bool RtpSender::initUdpSocket(const SdpStruct& sdp) {
     const int flags = fcntl(_rtp_socket, F_GETFL, 0);
     if (flags == -1 || fcntl(_rtp_socket, F_SETFL, flags | O_NONBLOCK) == -1) {
         _logger.e("设置 socket 为非阻塞模式失败");
-        cleanup_socket();
+        close_socket();
         return false;
     }
 
@@ -141,13 +187,25 @@ bool RtpSender::initUdpSocket(const SdpStruct& sdp) {
     _remote_addr.sin_port = htons(sdp.remote_port);
     if (inet_pton(AF_INET, sdp.remote_host.c_str(), &_remote_addr.sin_addr) <= 0) {
         _logger.eFmt("无效的目标主机地址: %s", sdp.remote_host.c_str());
-        cleanup_socket();
+        close_socket();
         return false;
     }
 
+    // 探测 GSO：内核支持 UDP_SEGMENT 时 getsockopt 成功
+    _is_batch_enabled = RTP_UDP_BATCH != 0;
+    _is_gso_enabled = false;
+    if (_is_batch_enabled && RTP_UDP_GSO) {
+        int gso_size = 0;
+        socklen_t len = sizeof(gso_size);
+        _is_gso_enabled = getsockopt(_rtp_socket, SOL_UDP, UDP_SEGMENT, &gso_size, &len) == 0;
+    }
+
     init_ssrc_seq(sdp.ssrc);
-    _is_tcp = false;
-    _logger.i("UDP socket 初始化成功");
+    start_sender();
+    _logger.dBox()
+           .add("UDP socket 初始化成功")
+           .addFmt("按帧批量发送: %s，GSO: %s", _is_batch_enabled ? "开启" : "关闭", _is_gso_enabled ? "开启" : "关闭")
+           .print();
     return true;
 }
 
@@ -189,104 +247,1080 @@ void RtpSender::init_ssrc_seq(const std::string& ssrc) {
 }
 
 RtpSender::~RtpSender() {
-    if (_rtp_socket > 0) {
-        close(_rtp_socket);
-        _rtp_socket = -1;
+    stop();
+}
+
+RtpSender::FramePtr RtpSender::acquireFrame() {
+    {
+        std::lock_guard<std::mutex> lock(_queue_mutex);
+        if (!_free_frames.empty()) {
+            FramePtr frame = std::move(_free_frames.back());
+            _free_frames.pop_back();
+            return frame;
+        }
     }
+    return std::make_unique<Frame>();
 }
 
-void RtpSender::sendDataPacket(const uint8_t* pkt, const size_t pkt_len, const bool is_end, const uint32_t timestamp) {
-    if (pkt == nullptr || pkt_len == 0 || pkt_len > MAX_RTP_PAYLOAD) {
-        _logger.eFmt("Invalid packet data: pkt=%p, len=%zu", pkt, pkt_len);
+void RtpSender::enqueueFrame(FramePtr frame) {
+    if (!frame) {
         return;
     }
+    frame->size = 0;
+    for (const auto& segment : frame->segments) {
+        frame->size += segment.iov_len;
+    }
+
+    std::function<void()> key_frame_request;
+    {
+        std::lock_guard<std::mutex> lock(_queue_mutex);
+        auto& stats = _queue_stats;
+        if (!_is_sending || frame->size == 0) {
+            recycle_frame(std::move(frame));
+            return;
+        }
+
+        // 丢过参考帧：IDR 之前的视频帧都无法解码
+        if (frame->is_video && _is_waiting_for_key) {
+            if (!frame->is_key_frame) {
+                ++stats.dropped_frames;
+                ++stats.dropped_gop;
+                recycle_frame(std::move(frame));
+                return;
+            }
+            _is_waiting_for_key = false;
+        }
+
+        if (is_queue_full(*frame)) {
+            // 回放帧不占额度，丢了也腾不出空间
+            drop_queued([](const Frame& queued) {
+                return queued.is_droppable && !queued.is_replayed;
+            }, stats.dropped_non_ref);
+        }
+        if (is_queue_full(*frame)) {
+            if (frame->is_key_frame) {
+                // 新的 IDR 之前的视频帧已经不需要了
+                drop_queued([](const Frame& queued) {
+                    return queued.is_video;
+                }, stats.dropped_gop);
+            } else if (frame->is_droppable) {
+                ++stats.dropped_frames;
+                ++stats.dropped_non_ref;
+                recycle_frame(std::move(frame));
+                return;
+            } else {
+                // 参考帧放不下：丢弃排队中的非 IDR 视频帧和本帧，之后的视频帧丢弃到下一个 IDR
+                drop_queued([](const Frame& queued) {
+                    return queued.is_video && !queued.is_key_frame;
+                }, stats.dropped_gop);
+                ++stats.dropped_frames;
+                ++stats.dropped_gop;
+                recycle_frame(std::move(frame));
+                _is_waiting_for_key = true;
+                key_frame_request = _key_frame_request_callback;
+            }
+        }
+
+        if (frame) {
+            stats.queued_bytes += frame->size;
+            if (frame->is_replayed) {
+                ++stats.replay_frames;
+                stats.replay_bytes += frame->size;
+            }
+            stats.max_queued_bytes = std::max(stats.max_queued_bytes, stats.queued_bytes);
+            _queue.push_back(std::move(frame));
+        }
+        stats.queued_frames = _queue.size();
+    }
+    _queue_cv.notify_one();
 
-    std::lock_guard<std::mutex> lock(_buffer_mutex);
+    if (key_frame_request) {
+        _logger.w("Send queue overflow, dropping video until next IDR");
+        key_frame_request();
+    }
+}
 
-    // 填充 RTP 头 (12 bytes)
-    _rtp_buffer[0] = 0x80;
-    _rtp_buffer[1] = (is_end ? 0x80 : 0x00) | (_payload_type & 0x7F);
-    _rtp_buffer[2] = (_seq >> 8) & 0xFF;
-    _rtp_buffer[3] = _seq & 0xFF;
-    _rtp_buffer[4] = (timestamp >> 24) & 0xFF;
-    _rtp_buffer[5] = (timestamp >> 16) & 0xFF;
-    _rtp_buffer[6] = (timestamp >> 8) & 0xFF;
-    _rtp_buffer[7] = timestamp & 0xFF;
-    _rtp_buffer[8] = (_ssrc >> 24) & 0xFF;
-    _rtp_buffer[9] = (_ssrc >> 16) & 0xFF;
-    _rtp_buffer[10] = (_ssrc >> 8) & 0xFF;
-    _rtp_buffer[11] = _ssrc & 0xFF;
+void RtpSender::setKeyFrameRequestCallback(const std::function<void()>& callback) {
+    std::lock_guard<std::mutex> lock(_queue_mutex);
+    _key_frame_request_callback = callback;
+}
 
-    // 填充负载
-    memcpy(_rtp_buffer + 12, pkt, pkt_len);
+bool RtpSender::is_queue_full(const Frame& frame) const {
+    const auto& stats = _queue_stats;
+    const size_t live_frames = _queue.size() - stats.replay_frames;
+    if (frame.is_replayed || live_frames == 0) {
+        // 单帧超过上限也要发送，否则大 IDR 永远发不出去
+        return false;
+    }
+    return live_frames >= RTP_SEND_QUEUE_MAX_FRAMES ||
+           stats.queued_bytes - stats.replay_bytes + frame.size > RTP_SEND_QUEUE_MAX_BYTES;
+}
 
-    send_packet(_rtp_buffer, 12 + pkt_len);
-    _seq++;
+void RtpSender::on_dequeued(const Frame& frame) {
+    auto& stats = _queue_stats;
+    stats.queued_bytes -= frame.size;
+    if (frame.is_replayed) {
+        --stats.replay_frames;
+        stats.replay_bytes -= frame.size;
+    }
 }
 
-void RtpSender::send_packet(const uint8_t* rtp_packet, const size_t rtp_len) {
+void RtpSender::drop_queued(const std::function<bool(const Frame&)>& predicate, uint64_t& counter) {
+    auto& stats = _queue_stats;
+    for (auto it = _queue.begin(); it != _queue.end();) {
+        if (!predicate(**it)) {
+            ++it;
+            continue;
+        }
+        on_dequeued(**it);
+        ++stats.dropped_frames;
+        ++counter;
+        recycle_frame(std::move(*it));
+        it = _queue.erase(it);
+    }
+    stats.queued_frames = _queue.size();
+}
+
+void RtpSender::recycle_frame(FramePtr frame) {
+    frame->segments.clear();
+    frame->payload_owner.reset();
+    frame->size = 0;
+    frame->is_video = true;
+    frame->is_key_frame = false;
+    frame->is_droppable = false;
+    frame->is_replayed = false;
+    if (_free_frames.size() < RTP_SEND_QUEUE_MAX_FRAMES) {
+        _free_frames.push_back(std::move(frame));
+    }
+}
+
+void RtpSender::start_sender() {
+    _epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (_epoll_fd >= 0) {
+        epoll_event event{};
+        event.events = EPOLLOUT;
+        event.data.fd = _rtp_socket;
+        if (epoll_ctl(_epoll_fd, EPOLL_CTL_ADD, _rtp_socket, &event) < 0) {
+            _logger.eFmt("epoll_ctl failed: %d", errno);
+        }
+    } else {
+        _logger.eFmt("epoll_create1 failed: %d", errno);
+    }
+
+    // UDP 可选 io_uring：要求提交后请求数据即稳定、CQ 不丢事件、等待可带超时（内核 5.11+）
+    _is_uring_enabled = false;
+    if (!_is_tcp && RTP_IO_URING) {
+        constexpr unsigned required_features = IORING_FEAT_SUBMIT_STABLE | IORING_FEAT_NODROP | IORING_FEAT_EXT_ARG;
+        if (_uring.init(URING_ENTRIES, required_features) && _uring.registerFiles(&_rtp_socket, 1)) {
+            _is_uring_enabled = true;
+        } else {
+            _uring.release();
+            _logger.w("io_uring unavailable, fallback to sendmmsg");
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(_queue_mutex);
+        _is_sending = true;
+        _is_waiting_for_key = false;
+    }
+    _last_stats_log_us = 0;
+    _sender_thread_ptr = std::make_unique<std::thread>(&RtpSender::sender_loop, this);
+}
+
+void RtpSender::stop_sender() {
+    {
+        std::lock_guard<std::mutex> lock(_queue_mutex);
+        _is_sending = false;
+    }
+    _queue_cv.notify_all();
+    if (_sender_thread_ptr && _sender_thread_ptr->joinable()) {
+        _sender_thread_ptr->join();
+    }
+    _sender_thread_ptr.reset();
+
     if (_is_tcp) {
-        const uint8_t header[4] = {
-            0x24, // '$'
-            0x00, // channel 0 for RTP
-            static_cast<uint8_t>((rtp_len >> 8) & 0xFF),
-            static_cast<uint8_t>(rtp_len & 0xFF)
-        };
-
-        // 发送 header - 确保完整发送
-        size_t total_sent = 0;
-        while (total_sent < 4) {
-            const ssize_t sent = send(_rtp_socket, header + total_sent, 4 - total_sent, MSG_NOSIGNAL);
-            if (sent < 0) {
-                if (errno == EAGAIN || errno == EWOULDBLOCK) {
-                    continue; // 非阻塞模式下的正常情况，继续尝试
-                }
-                _logger.eFmt("TCP 发送 RTP 头部失败: %d", errno);
+        drain_zerocopy();
+    }
+    if (_uring.isOpen()) {
+        drain_uring(true);
+        if (_uring_pending > 0) {
+            // 内核可能仍在引用这些帧的负载，宁可泄漏也不回收
+            _logger.wFmt("%zu io_uring requests still pending, leaking %zu frames", _uring_pending,
+                         _uring_frames.size());
+            for (auto& in_flight : _uring_frames) {
+                in_flight.release();
+            }
+            _uring_frames.clear();
+        }
+        _uring.release();
+        _uring_pending = 0;
+        _uring_last_sqe = nullptr;
+        _is_uring_enabled = false;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(_queue_mutex);
+        while (!_queue.empty()) {
+            recycle_frame(std::move(_queue.front()));
+            _queue.pop_front();
+        }
+        _queue_stats.queued_frames = 0;
+        _queue_stats.queued_bytes = 0;
+        _queue_stats.replay_frames = 0;
+        _queue_stats.replay_bytes = 0;
+    }
+
+    if (_epoll_fd >= 0) {
+        close(_epoll_fd);
+        _epoll_fd = -1;
+    }
+}
+
+void RtpSender::sender_loop() {
+    while (true) {
+        FramePtr frame;
+        {
+            std::unique_lock<std::mutex> lock(_queue_mutex);
+            _queue_cv.wait(lock, [this] {
+                return !_is_sending || !_queue.empty();
+            });
+            if (!_is_sending) {
                 return;
             }
-            total_sent += sent;
-        }
-
-        // 发送 RTP 数据 - 确保完整发送
-        total_sent = 0;
-        while (total_sent < rtp_len) {
-            const ssize_t sent = send(_rtp_socket,
-                                      rtp_packet + total_sent,
-                                      rtp_len - total_sent,
-                                      MSG_NOSIGNAL);
-            if (sent < 0) {
-                if (errno == EAGAIN || errno == EWOULDBLOCK) {
-                    continue; // 非阻塞模式下的正常情况，继续尝试
+            frame = std::move(_queue.front());
+            _queue.pop_front();
+            on_dequeued(*frame);
+            _queue_stats.queued_frames = _queue.size();
+        }
+
+        send_frame(std::move(frame));
+        if (_uring.isOpen()) {
+            // 没有下一帧时等待未完成的请求，帧和负载尽早回收
+            drain_uring(false);
+        }
+        if (!_zerocopy_frames.empty()) {
+            reap_zerocopy();
+        }
+        log_queue_stats();
+    }
+}
+
+void RtpSender::send_frame(FramePtr frame) {
+    if (_is_tcp) {
+        // 内核中未发出的数据低于 TCP_NOTSENT_LOWAT 才开始发送下一帧
+        if (!wait_writable()) {
+            finish_frame(std::move(frame));
+            return;
+        }
+        if (_is_zerocopy_enabled && frame->size >= RTP_TCP_ZEROCOPY_MIN_BYTES) {
+            send_frame_zerocopy(std::move(frame));
+            return;
+        }
+        send_frame_tcp(*frame);
+    } else if (_is_uring_enabled) {
+        send_frame_uring(std::move(frame));
+        return;
+    } else if (_is_batch_enabled) {
+        send_frame_batched(*frame);
+    } else {
+        send_frame_packets(*frame);
+    }
+    finish_frame(std::move(frame));
+}
+
+void RtpSender::finish_frame(FramePtr frame) {
+    std::lock_guard<std::mutex> lock(_queue_mutex);
+    ++_queue_stats.sent_frames;
+    recycle_frame(std::move(frame));
+}
+
+void RtpSender::send_frame_packets(const Frame& frame) {
+    PacketCursor cursor;
+    size_t sent_len = 0;
+    while (sent_len < frame.size) {
+        iovec iov[MAX_IOV_PER_PACKET];
+        size_t payload_iov_count = 0;
+        const size_t payload_len = slice_packet(frame, cursor, iov + 1, MAX_IOV_PER_PACKET - 1, payload_iov_count);
+        sent_len += payload_len;
+
+        write_rtp_header(_rtp_header, sent_len == frame.size, frame.timestamp);
+        iov[0].iov_base = _rtp_header;
+        iov[0].iov_len = RTP_HEADER_SIZE;
+
+        const bool is_sent = send_udp_packet(iov, payload_iov_count + 1, RTP_HEADER_SIZE + payload_len);
+        _seq++;
+        if (!is_sent) {
+            return;
+        }
+    }
+    CopyStats::get()->onGather(frame.size);
+}
+
+void RtpSender::send_frame_tcp(const Frame& frame, InFlightFrame* zerocopy_frame) {
+    PacketCursor cursor;
+    size_t sent_len = 0;
+    while (sent_len < frame.size) {
+        // 零拷贝时头部同样由内核引用，每批使用独立的缓冲区，收到完成通知后才能复用
+        BatchBuffers* batch = &_batch;
+        if (zerocopy_frame) {
+            zerocopy_frame->batches.push_back(acquire_batch());
+            batch = zerocopy_frame->batches.back().get();
+        }
+
+        // 一批 RTP 包连同各自的分帧头一次写入，分帧头和 RTP 头相邻，共用一个 iovec
+        size_t packet_count = 0;
+        size_t iov_used = 0;
+        size_t batch_len = 0;
+        while (sent_len < frame.size && packet_count < BATCH_MAX_PACKETS) {
+            size_t payload_iov_count = 0;
+            const size_t payload_len = slice_packet(frame, cursor, batch->iovs + iov_used + 1,
+                                                    MAX_IOV_PER_PACKET - 1, payload_iov_count);
+            sent_len += payload_len;
+
+            uint8_t* header = batch->headers[packet_count];
+            const size_t framing_size = write_tcp_framing(header, RTP_HEADER_SIZE + payload_len);
+            write_rtp_header(header + framing_size, sent_len == frame.size, frame.timestamp);
+            _seq++;
+            batch->iovs[iov_used].iov_base = header;
+            batch->iovs[iov_used].iov_len = framing_size + RTP_HEADER_SIZE;
+
+            iov_used += payload_iov_count + 1;
+            batch_len += framing_size + RTP_HEADER_SIZE + payload_len;
+            ++packet_count;
+        }
+
+        if (!send_tcp(batch->iovs, iov_used, batch_len, sent_len < frame.size, zerocopy_frame)) {
+            return;
+        }
+        _sent_packets.fetch_add(packet_count, std::memory_order_relaxed);
+    }
+    CopyStats::get()->onGather(frame.size);
+}
+
+void RtpSender::send_frame_zerocopy(FramePtr frame) {
+    _zerocopy_frames.push_back(acquire_in_flight_frame(std::move(frame)));
+    InFlightFrame* current = _zerocopy_frames.back().get();
+    current->first_zerocopy_id = _zerocopy_next_id;
+    send_frame_tcp(*current->frame, current);
+    if (current->zerocopy_count > 0) {
+        _zerocopy_sent_frames.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    current->is_prepared = true;
+    if (current->pending == 0) {
+        // 通知都已收到（或一次零拷贝发送也没有成功）
+        complete_in_flight_frame(_zerocopy_frames, current);
+    }
+}
+
+size_t RtpSender::reap_zerocopy() {
+    size_t notification_count = 0;
+    while (true) {
+        // IP_RECVERR：sock_extended_err + 源地址
+        alignas(cmsghdr) uint8_t control[CMSG_SPACE(sizeof(sock_extended_err) + sizeof(sockaddr_in6))];
+        msghdr msg{};
+        msg.msg_control = control;
+        msg.msg_controllen = sizeof(control);
+        if (recvmsg(_rtp_socket, &msg, MSG_ERRQUEUE | MSG_DONTWAIT) < 0) {
+            // EAGAIN：错误队列已空
+            break;
+        }
+
+        for (cmsghdr* cmsg = CMSG_FIRSTHDR(&msg); cmsg; cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+            const bool is_recv_err = (cmsg->cmsg_level == SOL_IP && cmsg->cmsg_type == IP_RECVERR) ||
+                                     (cmsg->cmsg_level == SOL_IPV6 && cmsg->cmsg_type == IPV6_RECVERR);
+            if (!is_recv_err) {
+                continue;
+            }
+            sock_extended_err err{};
+            memcpy(&err, CMSG_DATA(cmsg), sizeof(err));
+            if (err.ee_errno != 0 || err.ee_origin != SO_EE_ORIGIN_ZEROCOPY) {
+                continue;
+            }
+            ++notification_count;
+
+            // 一个通知覆盖连续的序号 [ee_info, ee_data]
+            const uint32_t first_id = err.ee_info;
+            const uint32_t id_count = err.ee_data - err.ee_info + 1;
+            if (err.ee_code & SO_EE_CODE_ZEROCOPY_COPIED) {
+                // 内核回退为拷贝（回环、网卡不支持 SG/校验和卸载），零拷贝只剩页面固定和通知的开销
+                _zerocopy_copied.fetch_add(id_count, std::memory_order_relaxed);
+                if (_is_zerocopy_enabled) {
+                    _is_zerocopy_enabled = false;
+                    _logger.w("MSG_ZEROCOPY fell back to copy on this route, disable zerocopy");
                 }
-                _logger.eFmt("TCP 发送 RTP 数据失败，已发送 %zu/%zu 字节，错误: %d", total_sent,
-                             rtp_len,
-                             errno);
-                return;
             }
-            total_sent += sent;
+
+            for (size_t i = 0; i < _zerocopy_frames.size();) {
+                InFlightFrame* in_flight = _zerocopy_frames[i].get();
+                const uint32_t done = zerocopy_id_overlap(first_id, id_count, in_flight->first_zerocopy_id,
+                                                          in_flight->zerocopy_count);
+                in_flight->pending -= done;
+                if (done > 0 && in_flight->pending == 0 && in_flight->is_prepared) {
+                    // 移除后当前位置换成了最后一个帧
+                    complete_in_flight_frame(_zerocopy_frames, in_flight);
+                    continue;
+                }
+                ++i;
+            }
         }
+    }
+    return notification_count;
+}
 
-        if (total_sent != rtp_len) {
-            _logger.eFmt("TCP 数据发送不完整，期望 %zu 字节，实际发送 %zu 字节", rtp_len, total_sent);
+void RtpSender::drain_zerocopy() {
+    const auto deadline = std::chrono::steady_clock::now() +
+                          std::chrono::microseconds(static_cast<int64_t>(IN_FLIGHT_DRAIN_TIMEOUT_US));
+    while (!_zerocopy_frames.empty() && std::chrono::steady_clock::now() < deadline) {
+        if (reap_zerocopy() == 0) {
+            // 不关注任何事件时，错误队列非空以 POLLERR 返回
+            pollfd fd{_rtp_socket, 0, 0};
+            poll(&fd, 1, WRITABLE_WAIT_MS);
+        }
+    }
+    if (!_zerocopy_frames.empty()) {
+        // 页面由内核持有引用，回收帧不会让内核访问已释放的内存，socket 随后关闭
+        _logger.wFmt("%zu zerocopy frames not completed, recycling", _zerocopy_frames.size());
+        while (!_zerocopy_frames.empty()) {
+            complete_in_flight_frame(_zerocopy_frames, _zerocopy_frames.back().get());
         }
+    }
+    _zerocopy_next_id = 0;
+}
+
+std::unique_ptr<RtpSender::InFlightFrame> RtpSender::acquire_in_flight_frame(FramePtr frame) {
+    std::unique_ptr<InFlightFrame> in_flight;
+    if (!_free_in_flight_frames.empty()) {
+        in_flight = std::move(_free_in_flight_frames.back());
+        _free_in_flight_frames.pop_back();
     } else {
-        const ssize_t sent = sendto(_rtp_socket,
-                                    rtp_packet,
-                                    rtp_len,
-                                    MSG_NOSIGNAL,
-                                    reinterpret_cast<struct sockaddr*>(&_remote_addr),
-                                    sizeof(_remote_addr));
+        in_flight = std::make_unique<InFlightFrame>();
+    }
+    in_flight->frame = std::move(frame);
+    in_flight->pending = 0;
+    in_flight->is_prepared = false;
+    in_flight->first_zerocopy_id = 0;
+    in_flight->zerocopy_count = 0;
+    return in_flight;
+}
+
+std::unique_ptr<RtpSender::BatchBuffers> RtpSender::acquire_batch() {
+    if (_free_batches.empty()) {
+        return std::make_unique<BatchBuffers>();
+    }
+    std::unique_ptr<BatchBuffers> batch = std::move(_free_batches.back());
+    _free_batches.pop_back();
+    return batch;
+}
+
+void RtpSender::complete_in_flight_frame(std::vector<std::unique_ptr<InFlightFrame>>& frames,
+                                         InFlightFrame* in_flight) {
+    for (auto& batch : in_flight->batches) {
+        if (_free_batches.size() < FREE_BATCHES_MAX) {
+            _free_batches.push_back(std::move(batch));
+        }
+    }
+    in_flight->batches.clear();
+    finish_frame(std::move(in_flight->frame));
+
+    const auto it = std::find_if(frames.begin(), frames.end(),
+                                 [in_flight](const std::unique_ptr<InFlightFrame>& item) {
+                                     return item.get() == in_flight;
+                                 });
+    if (it != frames.end()) {
+        _free_in_flight_frames.push_back(std::move(*it));
+        *it = std::move(frames.back());
+        frames.pop_back();
+    }
+}
+
+void RtpSender::send_frame_batched(const Frame& frame) {
+    PacketCursor cursor;
+    size_t sent_len = 0;
+    while (sent_len < frame.size) {
+        build_udp_batch(frame, cursor, sent_len, _batch);
+        if (!send_batch(_batch)) {
+            return;
+        }
+    }
+    CopyStats::get()->onGather(frame.size);
+}
+
+void RtpSender::build_udp_batch(const Frame& frame, PacketCursor& cursor, size_t& sent_len, BatchBuffers& batch) {
+    // 切出一批 RTP 包，连续等长的包（最后一个可以更短）合并为一个 GSO 消息
+    size_t packet_count = 0;
+    size_t message_count = 0;
+    size_t iov_used = 0;
+    while (sent_len < frame.size && packet_count < BATCH_MAX_PACKETS) {
+        size_t payload_iov_count = 0;
+        const size_t payload_len = slice_packet(frame, cursor, batch.iovs + iov_used + 1, MAX_IOV_PER_PACKET - 1,
+                                                payload_iov_count);
+        sent_len += payload_len;
+
+        uint8_t* header = batch.headers[packet_count];
+        write_rtp_header(header, sent_len == frame.size, frame.timestamp);
+        _seq++;
+        batch.iovs[iov_used].iov_base = header;
+        batch.iovs[iov_used].iov_len = RTP_HEADER_SIZE;
+
+        BatchPacket& packet = batch.packets[packet_count];
+        packet.iov_index = iov_used;
+        packet.iov_count = payload_iov_count + 1;
+        packet.len = RTP_HEADER_SIZE + payload_len;
+        iov_used += packet.iov_count;
+
+        BatchMessage* message = message_count > 0 ? &batch.messages[message_count - 1] : nullptr;
+        const bool is_joinable = _is_gso_enabled && message && !message->is_closed &&
+                                 message->packet_count < UDP_GSO_MAX_SEGMENTS &&
+                                 packet.len <= message->segment_size &&
+                                 message->bytes + packet.len <= UDP_GSO_MAX_BYTES;
+        if (is_joinable) {
+            ++message->packet_count;
+            message->bytes += packet.len;
+            message->is_closed = packet.len < message->segment_size;
+        } else {
+            message = &batch.messages[message_count++];
+            message->first_packet = packet_count;
+            message->packet_count = 1;
+            message->segment_size = packet.len;
+            message->bytes = packet.len;
+            message->is_closed = false;
+        }
+        ++packet_count;
+    }
+    batch.packet_count = packet_count;
+    batch.message_count = message_count;
+
+    for (size_t i = 0; i < message_count; ++i) {
+        const BatchMessage& message = batch.messages[i];
+        const BatchPacket& first = batch.packets[message.first_packet];
+        const BatchPacket& last = batch.packets[message.first_packet + message.packet_count - 1];
+
+        msghdr& msg = batch.msgs[i].msg_hdr;
+        msg = msghdr{};
+        msg.msg_name = &_remote_addr;
+        msg.msg_namelen = sizeof(_remote_addr);
+        msg.msg_iov = batch.iovs + first.iov_index;
+        msg.msg_iovlen = last.iov_index + last.iov_count - first.iov_index;
+        if (message.packet_count > 1) {
+            // 内核按 segment_size 把消息切分为多个数据报，每个数据报正好是一个 RTP 包
+            msg.msg_control = batch.cmsgs[i];
+            msg.msg_controllen = sizeof(batch.cmsgs[i]);
+            cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+            cmsg->cmsg_level = SOL_UDP;
+            cmsg->cmsg_type = UDP_SEGMENT;
+            cmsg->cmsg_len = CMSG_LEN(sizeof(uint16_t));
+            const auto segment_size = static_cast<uint16_t>(message.segment_size);
+            memcpy(CMSG_DATA(cmsg), &segment_size, sizeof(segment_size));
+        }
+    }
+}
+
+size_t RtpSender::slice_packet(const Frame& frame, PacketCursor& cursor, iovec* iov, const size_t max_iov,
+                               size_t& iov_count) const {
+    const iovec* segments = frame.segments.data();
+    const size_t segment_count = frame.segments.size();
+    size_t payload_len = 0;
+    iov_count = 0;
+    while (payload_len < MAX_RTP_PAYLOAD && cursor.segment_index < segment_count && iov_count < max_iov) {
+        const iovec& segment = segments[cursor.segment_index];
+        // 放得进一个空包、但放不进当前包剩余空间的分段，留到下一个包
+        if (cursor.segment_offset == 0 && payload_len > 0 && segment.iov_len > MAX_RTP_PAYLOAD - payload_len &&
+            segment.iov_len <= MAX_RTP_PAYLOAD) {
+            break;
+        }
+        const size_t available = segment.iov_len - cursor.segment_offset;
+        const size_t take = std::min(available, MAX_RTP_PAYLOAD - payload_len);
+        if (take > 0) {
+            iov[iov_count].iov_base = static_cast<uint8_t*>(segment.iov_base) + cursor.segment_offset;
+            iov[iov_count].iov_len = take;
+            ++iov_count;
+            payload_len += take;
+            cursor.segment_offset += take;
+        }
+        if (cursor.segment_offset == segment.iov_len) {
+            ++cursor.segment_index;
+            cursor.segment_offset = 0;
+        }
+    }
+    return payload_len;
+}
+
+bool RtpSender::send_batch(BatchBuffers& batch) {
+    const size_t message_count = batch.message_count;
+    size_t sent = 0;
+    while (sent < message_count) {
+        const int ret = sendmmsg(_rtp_socket, batch.msgs + sent, static_cast<unsigned int>(message_count - sent),
+                                 MSG_NOSIGNAL);
+        _send_calls.fetch_add(1, std::memory_order_relaxed);
+        if (ret > 0) {
+            for (int i = 0; i < ret; ++i) {
+                _sent_packets.fetch_add(batch.messages[sent + i].packet_count, std::memory_order_relaxed);
+            }
+            sent += ret;
+            continue;
+        }
+
+        const int error = errno;
+        if (error == EAGAIN || error == EWOULDBLOCK) {
+            // 发送缓冲区满：等待可写后继续发送剩余消息
+            _would_block_count.fetch_add(1, std::memory_order_relaxed);
+            if (!wait_writable()) {
+                return false;
+            }
+            continue;
+        }
+        if (error == EINTR) {
+            continue;
+        }
+
+        const BatchMessage& message = batch.messages[sent];
+        const bool is_gso_error = message.packet_count > 1 &&
+                                  (error == EIO || error == EINVAL || error == ENOPROTOOPT || error == EOPNOTSUPP);
+        if (is_gso_error || error == ENOSYS) {
+            // GSO（网卡不支持校验和卸载等）或 sendmmsg 不可用：关闭对应功能，本批剩余的包逐个发送
+            if (is_gso_error) {
+                _is_gso_enabled = false;
+                _logger.wFmt("UDP GSO send failed (%d), fallback to one datagram per packet", error);
+            } else {
+                _is_batch_enabled = false;
+                _logger.w("sendmmsg not supported, fallback to per-packet send");
+            }
+            const BatchMessage& last_message = batch.messages[message_count - 1];
+            const size_t packet_end = last_message.first_packet + last_message.packet_count;
+            for (size_t i = message.first_packet; i < packet_end; ++i) {
+                const BatchPacket& packet = batch.packets[i];
+                if (!send_udp_packet(batch.iovs + packet.iov_index, packet.iov_count, packet.len)) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        if (error == ENOBUFS) {
+            _would_block_count.fetch_add(1, std::memory_order_relaxed);
+        }
+        _send_error_count.fetch_add(message.packet_count, std::memory_order_relaxed);
+        _logger.eFmt("UDP 批量发送 RTP 数据失败，错误: %d (%s)", error, strerror(error));
+        // 单个消息发送失败不影响后续消息
+        ++sent;
+    }
+    return true;
+}
+
+void RtpSender::send_frame_uring(FramePtr frame) {
+    _uring_frames.push_back(acquire_in_flight_frame(std::move(frame)));
+    InFlightFrame* current = _uring_frames.back().get();
+
+    const Frame& sending = *current->frame;
+    PacketCursor cursor;
+    size_t sent_len = 0;
+    bool is_failed = false;
+    while (sent_len < sending.size && !is_failed) {
+        std::unique_ptr<BatchBuffers> batch = acquire_batch();
+        build_udp_batch(sending, cursor, sent_len, *batch);
+        const BatchBuffers& prepared = *batch;
+        current->batches.push_back(std::move(batch));
+
+        for (size_t i = 0; i < prepared.message_count; ++i) {
+            io_uring_sqe* sqe = next_uring_sqe();
+            if (!sqe) {
+                is_failed = true;
+                break;
+            }
+            const BatchMessage& message = prepared.messages[i];
+            sqe->opcode = IORING_OP_SENDMSG;
+            sqe->fd = 0; // 固定文件下标
+            // 同一次提交内的请求按顺序链接，socket 暂时不可写时也不会乱序
+            sqe->flags = IOSQE_FIXED_FILE | IOSQE_IO_LINK;
+            sqe->addr = reinterpret_cast<uint64_t>(&prepared.msgs[i].msg_hdr);
+            sqe->len = 1;
+            sqe->msg_flags = MSG_NOSIGNAL;
+            sqe->user_data = reinterpret_cast<uint64_t>(current) | (message.packet_count > 1 ? URING_GSO_FLAG : 0);
+            _uring_last_sqe = sqe;
+            ++current->pending;
+            ++_uring_pending;
+            _sent_packets.fetch_add(message.packet_count, std::memory_order_relaxed);
+        }
+    }
+    if (!is_failed) {
+        CopyStats::get()->onGather(sending.size);
+    }
+    current->is_prepared = true;
+    if (current->pending == 0) {
+        // 请求都已完成（或一个也没有放入 SQ）
+        complete_in_flight_frame(_uring_frames, current);
+    }
+
+    // 一次系统调用提交本帧剩余的请求，不等待完成
+    submit_uring(0);
+    reap_uring();
+}
+
+io_uring_sqe* RtpSender::next_uring_sqe() {
+    while (true) {
+        if (_uring_pending < _uring.sqEntries()) {
+            io_uring_sqe* sqe = _uring.getSqe();
+            if (sqe) {
+                return sqe;
+            }
+        }
+        // SQ 已满：提交已填充的请求并等待完成事件
+        if (!submit_uring(1, WRITABLE_WAIT_MS)) {
+            return nullptr;
+        }
+        reap_uring();
+        std::lock_guard<std::mutex> lock(_queue_mutex);
+        if (!_is_sending) {
+            return nullptr;
+        }
+    }
+}
+
+bool RtpSender::submit_uring(const unsigned wait_nr, const int timeout_ms) {
+    if (_uring_last_sqe) {
+        // 链接只在一次提交内有效：最后一个请求不再链接到之后的请求
+        _uring_last_sqe->flags &= ~IOSQE_IO_LINK;
+        _uring_last_sqe = nullptr;
+    }
+    const int ret = _uring.submit(wait_nr, timeout_ms);
+    _send_calls.fetch_add(1, std::memory_order_relaxed);
+    if (ret >= 0 || ret == -ETIME || ret == -EINTR || ret == -EAGAIN || ret == -EBUSY) {
+        return true;
+    }
+    if (_is_uring_enabled) {
+        _is_uring_enabled = false;
+        _logger.eFmt("io_uring_enter failed: %d (%s), fallback to sendmmsg", -ret, strerror(-ret));
+    }
+    return false;
+}
+
+void RtpSender::reap_uring() {
+    io_uring_cqe cqe{};
+    while (_uring.peekCqe(cqe)) {
+        auto* in_flight = reinterpret_cast<InFlightFrame*>(cqe.user_data & ~URING_GSO_FLAG);
+        const bool is_gso = (cqe.user_data & URING_GSO_FLAG) != 0;
+        if (cqe.res < 0) {
+            const int error = -cqe.res;
+            _send_error_count.fetch_add(1, std::memory_order_relaxed);
+            if (error == ENOBUFS || error == EAGAIN) {
+                _would_block_count.fetch_add(1, std::memory_order_relaxed);
+            }
+            if (is_gso && _is_gso_enabled &&
+                (error == EIO || error == EINVAL || error == ENOPROTOOPT || error == EOPNOTSUPP)) {
+                // 网卡/内核不支持 GSO：之后的帧不再合并
+                _is_gso_enabled = false;
+                _logger.wFmt("UDP GSO send failed (%d), fallback to one datagram per packet", error);
+            } else if (error != ECANCELED) {
+                // ECANCELED 为链中前一个请求失败后被取消的请求，不重复打印
+                _logger.eFmt("io_uring 发送 RTP 数据失败，错误: %d (%s)", error, strerror(error));
+            }
+        }
+        --_uring_pending;
+        if (--in_flight->pending == 0 && in_flight->is_prepared) {
+            complete_in_flight_frame(_uring_frames, in_flight);
+        }
+    }
+}
+
+void RtpSender::drain_uring(const bool wait_for_all) {
+    const auto deadline = std::chrono::steady_clock::now() +
+                          std::chrono::microseconds(static_cast<int64_t>(IN_FLIGHT_DRAIN_TIMEOUT_US));
+    while (_uring_pending > 0) {
+        if (wait_for_all) {
+            if (std::chrono::steady_clock::now() > deadline) {
+                break;
+            }
+        } else {
+            std::lock_guard<std::mutex> lock(_queue_mutex);
+            if (!_is_sending || !_queue.empty()) {
+                break;
+            }
+        }
+        if (!submit_uring(1, WRITABLE_WAIT_MS)) {
+            break;
+        }
+        reap_uring();
+    }
+}
+
+bool RtpSender::wait_writable() {
+    if (_epoll_fd < 0) {
+        return _is_sending;
+    }
+    epoll_event event{};
+    if (epoll_wait(_epoll_fd, &event, 1, 0) > 0 && check_writable(event.events)) {
+        return true;
+    }
+
+    // 不可写：阻塞等待（不占 CPU），周期性检查是否已停止发送
+    _stalls.fetch_add(1, std::memory_order_relaxed);
+    const auto start = std::chrono::steady_clock::now();
+    bool is_writable = false;
+    while (true) {
+        {
+            std::lock_guard<std::mutex> lock(_queue_mutex);
+            if (!_is_sending) {
+                break;
+            }
+        }
+        const int ret = epoll_wait(_epoll_fd, &event, 1, WRITABLE_WAIT_MS);
+        if (ret > 0) {
+            if (!check_writable(event.events)) {
+                continue;
+            }
+            is_writable = true;
+            break;
+        }
+        if (ret < 0 && errno != EINTR) {
+            _logger.eFmt("epoll_wait failed: %d", errno);
+            break;
+        }
+    }
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    _stall_us.fetch_add(std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count(),
+                        std::memory_order_relaxed);
+    return is_writable;
+}
+
+bool RtpSender::check_writable(const uint32_t events) {
+    if ((events & EPOLLERR) && _is_tcp && reap_zerocopy() > 0) {
+        return (events & EPOLLOUT) != 0;
+    }
+    // 没有零拷贝通知的 EPOLLERR 为 socket 错误，交给发送调用报告
+    return true;
+}
+
+RtpSender::SendQueueStats RtpSender::sendQueueStats() {
+    SendQueueStats stats;
+    {
+        std::lock_guard<std::mutex> lock(_queue_mutex);
+        stats = _queue_stats;
+    }
+    stats.stalls = _stalls.load(std::memory_order_relaxed);
+    stats.stall_us = _stall_us.load(std::memory_order_relaxed);
+    stats.sent_packets = _sent_packets.load(std::memory_order_relaxed);
+    stats.send_calls = _send_calls.load(std::memory_order_relaxed);
+    stats.zerocopy_frames = _zerocopy_sent_frames.load(std::memory_order_relaxed);
+    stats.zerocopy_copied = _zerocopy_copied.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void RtpSender::log_queue_stats() {
+    const int64_t now_us = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+    if (now_us - _last_stats_log_us < QUEUE_STATS_LOG_INTERVAL_US) {
+        return;
+    }
+    if (_last_stats_log_us == 0) {
+        _last_stats_log_us = now_us;
+        return;
+    }
+    _last_stats_log_us = now_us;
+
+    const auto stats = sendQueueStats();
+    _logger.dBox()
+           .add("发送队列统计")
+           .addFmt("排队: %zu 帧，%zu 字节（峰值 %zu 字节）", stats.queued_frames, stats.queued_bytes,
+                   stats.max_queued_bytes)
+           .addFmt("已发送: %llu 帧", static_cast<unsigned long long>(stats.sent_frames))
+           .addFmt("丢帧: %llu（非参考帧/音频 %llu，等待 IDR %llu）",
+                   static_cast<unsigned long long>(stats.dropped_frames),
+                   static_cast<unsigned long long>(stats.dropped_non_ref),
+                   static_cast<unsigned long long>(stats.dropped_gop))
+           .addFmt("等待可写: %llu 次，累计 %.1f ms", static_cast<unsigned long long>(stats.stalls),
+                   static_cast<double>(stats.stall_us) / 1000.0)
+           .addFmt("RTP 包: %llu，发送系统调用: %llu（每帧 %.2f 次）",
+                   static_cast<unsigned long long>(stats.sent_packets),
+                   static_cast<unsigned long long>(stats.send_calls),
+                   stats.sent_frames > 0 ? static_cast<double>(stats.send_calls) / stats.sent_frames : 0.0)
+           .addFmt("零拷贝: %llu 帧，回退拷贝 %llu 次", static_cast<unsigned long long>(stats.zerocopy_frames),
+                   static_cast<unsigned long long>(stats.zerocopy_copied))
+           .print();
+}
+
+size_t RtpSender::write_tcp_framing(uint8_t* dst, const size_t rtp_len) {
+#if RTP_TCP_FRAMING_RFC4571
+    // RFC 4571：2 字节 RTP 包长度
+    dst[0] = (rtp_len >> 8) & 0xFF;
+    dst[1] = rtp_len & 0xFF;
+#else
+    // RTSP interleaved（RFC 2326 10.12）：'$' + 通道 + 2 字节 RTP 包长度
+    dst[0] = 0x24; // '$'
+    dst[1] = 0x00; // channel 0 for RTP
+    dst[2] = (rtp_len >> 8) & 0xFF;
+    dst[3] = rtp_len & 0xFF;
+#endif
+    return TCP_FRAMING_SIZE;
+}
+
+void RtpSender::write_rtp_header(uint8_t* dst, const bool is_marker, const uint32_t timestamp) const {
+    dst[0] = 0x80;
+    dst[1] = (is_marker ? 0x80 : 0x00) | (_payload_type & 0x7F);
+    dst[2] = (_seq >> 8) & 0xFF;
+    dst[3] = _seq & 0xFF;
+    dst[4] = (timestamp >> 24) & 0xFF;
+    dst[5] = (timestamp >> 16) & 0xFF;
+    dst[6] = (timestamp >> 8) & 0xFF;
+    dst[7] = timestamp & 0xFF;
+    dst[8] = (_ssrc >> 24) & 0xFF;
+    dst[9] = (_ssrc >> 16) & 0xFF;
+    dst[10] = (_ssrc >> 8) & 0xFF;
+    dst[11] = _ssrc & 0xFF;
+}
+
+bool RtpSender::send_tcp(iovec* iov, const size_t iov_count, const size_t total_len, const bool has_more,
+                         InFlightFrame* zerocopy_frame) {
+    // 发送缓冲区满说明上行拥塞，每批只计一次，供码率控制使用
+    bool is_would_block = false;
+
+    // 部分发送时跳过已发出的 iovec 继续发送
+    int flags = MSG_NOSIGNAL | (has_more ? MSG_MORE : 0) | (zerocopy_frame ? MSG_ZEROCOPY : 0);
+    size_t total_sent = 0;
+    msghdr msg{};
+    msg.msg_iov = iov;
+    msg.msg_iovlen = iov_count;
+    while (total_sent < total_len) {
+        const ssize_t sent = sendmsg(_rtp_socket, &msg, flags);
+        _send_calls.fetch_add(1, std::memory_order_relaxed);
         if (sent < 0) {
-            _logger.eFmt("UDP 发送 RTP 数据失败，错误: %d (%s)", errno, strerror(errno));
-        } else if (static_cast<size_t>(sent) != rtp_len) {
-            _logger.eFmt("UDP 发送字节数不匹配，期望 %zu，实际 %zd", rtp_len, sent);
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                if (!is_would_block) {
+                    is_would_block = true;
+                    _would_block_count.fetch_add(1, std::memory_order_relaxed);
+                }
+                // 等待可写而不是空转；数据已发出一部分，必须发完，否则 TCP 流错位
+                if (!wait_writable()) {
+                    return false;
+                }
+                continue;
+            }
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno == ENOBUFS && (flags & MSG_ZEROCOPY)) {
+                // 固定的页面超过 optmem 上限：先回收已完成的帧，本批剩余部分拷贝发送
+                reap_zerocopy();
+                flags &= ~MSG_ZEROCOPY;
+                continue;
+            }
+            _send_error_count.fetch_add(1, std::memory_order_relaxed);
+            _logger.eFmt("TCP 发送 RTP 数据失败，已发送 %zu/%zu 字节，错误: %d", total_sent, total_len, errno);
+            return false;
+        }
+        total_sent += sent;
+        if (flags & MSG_ZEROCOPY) {
+            // 内核按成功的零拷贝发送调用依次分配通知序号
+            ++_zerocopy_next_id;
+            ++zerocopy_frame->zerocopy_count;
+            ++zerocopy_frame->pending;
+        }
+
+        size_t skip = sent;
+        while (skip > 0 && msg.msg_iovlen > 0) {
+            if (skip >= msg.msg_iov->iov_len) {
+                skip -= msg.msg_iov->iov_len;
+                ++msg.msg_iov;
+                --msg.msg_iovlen;
+            } else {
+                msg.msg_iov->iov_base = static_cast<uint8_t*>(msg.msg_iov->iov_base) + skip;
+                msg.msg_iov->iov_len -= skip;
+                skip = 0;
+            }
+        }
+    }
+    return true;
+}
+
+bool RtpSender::send_udp_packet(iovec* iov, const size_t iov_count, const size_t rtp_len) {
+    msghdr msg{};
+    msg.msg_name = &_remote_addr;
+    msg.msg_namelen = sizeof(_remote_addr);
+    msg.msg_iov = iov;
+    msg.msg_iovlen = iov_count;
+    while (true) {
+        const ssize_t sent = sendmsg(_rtp_socket, &msg, MSG_NOSIGNAL);
+        _send_calls.fetch_add(1, std::memory_order_relaxed);
+        if (sent >= 0) {
+            _sent_packets.fetch_add(1, std::memory_order_relaxed);
+            if (static_cast<size_t>(sent) != rtp_len) {
+                _logger.eFmt("UDP 发送字节数不匹配，期望 %zu，实际 %zd", rtp_len, sent);
+            }
+            return true;
+        }
+        if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            // 发送缓冲区满：等待可写后重试
+            _would_block_count.fetch_add(1, std::memory_order_relaxed);
+            if (!wait_writable()) {
+                return false;
+            }
+            continue;
         }
+        if (errno == ENOBUFS) {
+            _would_block_count.fetch_add(1, std::memory_order_relaxed);
+        }
+        _send_error_count.fetch_add(1, std::memory_order_relaxed);
+        _logger.eFmt("UDP 发送 RTP 数据失败，错误: %d (%s)", errno, strerror(errno));
+        // 单个 UDP 包发送失败不影响后续包
+        return true;
     }
 }
 
 void RtpSender::stop() {
-    if (_rtp_socket > 0) {
+    stop_sender();
+    close_socket();
+}
+
+bool RtpSender::open_socket(const bool is_tcp) {
+    const int socket_fd = socket(AF_INET, is_tcp ? SOCK_STREAM : SOCK_DGRAM, 0);
+    std::lock_guard<std::mutex> lock(_socket_mutex);
+    _rtp_socket = socket_fd;
+    _is_tcp = is_tcp;
+    return socket_fd >= 0;
+}
+
+void RtpSender::close_socket() {
+    std::lock_guard<std::mutex> lock(_socket_mutex);
+    if (_rtp_socket >= 0) {
         close(_rtp_socket);
         _rtp_socket = -1;
     }
 }
+
+RtpSender::NetworkStats RtpSender::networkStats() const {
+    NetworkStats stats;
+    stats.would_block = _would_block_count.load(std::memory_order_relaxed);
+    stats.send_errors = _send_error_count.load(std::memory_order_relaxed);
+    {
+        std::lock_guard<std::mutex> lock(_queue_mutex);
+        // 回放的 GOP 是一次性的积压，不代表网络拥塞，不让码率控制因此降码率
+        stats.queued_bytes = _queue_stats.queued_bytes - _queue_stats.replay_bytes;
+        stats.dropped_frames = _queue_stats.dropped_frames;
+    }
+
+    // 持锁期间 socket 不会被关闭
+    std::lock_guard<std::mutex> lock(_socket_mutex);
+    const int socket_fd = _rtp_socket;
+    if (socket_fd < 0) {
+        return stats;
+    }
+    stats.is_open = true;
+    stats.is_tcp = _is_tcp;
+
+    int queued = 0;
+    if (ioctl(socket_fd, SIOCOUTQ, &queued) == 0) {
+        stats.send_queue_bytes = queued;
+    }
+
+    if (stats.is_tcp) {
+        tcp_info info{};
+        socklen_t len = sizeof(info);
+        if (getsockopt(socket_fd, IPPROTO_TCP, TCP_INFO, &info, &len) == 0) {
+            stats.rtt_us = info.tcpi_rtt;
+            stats.unacked = info.tcpi_unacked;
+            stats.cwnd = info.tcpi_snd_cwnd;
+        }
+    }
+    return stats;
+}
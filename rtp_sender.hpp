@@ -6,13 +6,92 @@
 #define GB28181CONSOLE_RTP_SENDER_HPP
 
 #include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
 #include <mutex>
+#include <thread>
+#include <vector>
 
+#include "base_config.hpp"
+#include "io_uring.hpp"
 #include "logger.hpp"
 #include "sdp_parser.hpp"
 
+/**
+ * RTP 发送（PS over RTP，TCP / UDP）
+ *
+ * 封装层把整帧 PS 包放入有界队列后立即返回，由独立的发送线程分片发送：socket 不可写时用 epoll 等待而不是空转，
+ * TCP 用 TCP_NOTSENT_LOWAT 限制内核中未发出的数据量；队列溢出时按 GOP 丢帧，编码线程永远不会被网络阻塞。
+ *
+ * UDP 按帧批量发送：一帧的 RTP 包一次 sendmmsg 交给内核，连续等长的包再合并为一个 GSO 消息（UDP_SEGMENT），
+ * 由内核（或网卡）切分为多个数据报；内核不支持时回退到逐包 sendmsg。
+ * TCP 按帧合并写：一帧的分帧头 + RTP 包一次 sendmsg（writev）写入，帧内使用 MSG_MORE，帧尾由 TCP_NODELAY 立即发出。
+ * UDP 可选 io_uring（RTP_IO_URING）：一帧的消息作为一组 SENDMSG 请求一次提交，完成事件异步回收，帧在完成后才回收复用。
+ * TCP 可选零拷贝（RTP_TCP_ZEROCOPY）：大帧以 MSG_ZEROCOPY 发送，内核直接引用负载页面，错误队列通知完成后才回收帧。
+ * */
 class RtpSender {
 public:
+    /**
+     * 待发送的一帧（一个 PS 包），由 acquireFrame() 取得、填充后交给 enqueueFrame()，发送或丢弃后回收复用
+     */
+    struct Frame {
+        static constexpr size_t HEADER_CAPACITY = 512;
+
+        std::vector<iovec> segments;               // 按顺序拼成完整 PS 包的分段，可引用 headers 和负载
+        uint8_t headers[HEADER_CAPACITY]{};        // 逐帧生成的头部（PS 头、PES 头）
+        std::shared_ptr<const void> payload_owner; // 负载所有者（编码输出包 / 重新拼装的缓冲区），发送完成前保持有效
+        uint32_t timestamp = 0;
+        size_t size = 0;           // 入队时统计
+        bool is_video = true;
+        bool is_key_frame = false;
+        bool is_droppable = false; // 非参考帧（或音频帧），丢弃不影响后续帧解码，拥塞时优先丢弃
+        bool is_replayed = false;  // 新会话回放的 GOP 缓存帧，整组一次入队，不计入队列上限
+    };
+
+    using FramePtr = std::unique_ptr<Frame>;
+
+    /**
+     * 发送队列状态
+     */
+    struct SendQueueStats {
+        size_t queued_frames = 0;     // 当前排队帧数
+        size_t queued_bytes = 0;      // 当前排队字节数
+        size_t max_queued_bytes = 0;  // 排队字节数峰值
+        size_t replay_frames = 0;     // 排队中的 GOP 回放帧数（已含在 queued_frames 中）
+        size_t replay_bytes = 0;      // 排队中的 GOP 回放字节数（已含在 queued_bytes 中）
+        uint64_t sent_frames = 0;     // 已发送帧数
+        uint64_t dropped_frames = 0;  // 丢弃帧数（含下面两项）
+        uint64_t dropped_non_ref = 0; // 丢弃的非参考帧/音频帧
+        uint64_t dropped_gop = 0;     // 丢参考帧后等待 IDR 期间丢弃的视频帧
+        uint64_t stalls = 0;          // 等待 socket 可写的次数
+        uint64_t stall_us = 0;        // 等待 socket 可写的累计时长
+        uint64_t sent_packets = 0;    // 已发送 RTP 包数
+        uint64_t send_calls = 0;      // 发送系统调用次数（sendmsg / sendmmsg）
+        uint64_t zerocopy_frames = 0; // 以 MSG_ZEROCOPY 发送的帧数
+        uint64_t zerocopy_copied = 0; // 内核回退为拷贝的零拷贝发送次数
+    };
+
+    /**
+     * 发送通道状态，供码率控制使用
+     */
+    struct NetworkStats {
+        bool is_open = false;      // 是否有活动的 socket
+        bool is_tcp = false;       // 传输方式
+        uint32_t rtt_us = 0;       // TCP 平滑 RTT（微秒）
+        uint32_t unacked = 0;      // TCP 未确认报文段数
+        uint32_t cwnd = 0;         // TCP 拥塞窗口（报文段）
+        int send_queue_bytes = 0;  // 内核发送队列中尚未发出的字节数（SIOCOUTQ）
+        uint64_t would_block = 0;  // 累计遇到发送缓冲区满（EAGAIN）的次数
+        uint64_t send_errors = 0;  // 累计发送失败的 RTP 包数
+        size_t queued_bytes = 0;   // 发送队列（用户态）中排队的字节数，不含 GOP 回放
+        uint64_t dropped_frames = 0; // 累计因发送队列溢出丢弃的帧数
+    };
+
     explicit RtpSender();
 
     static RtpSender* get() {
@@ -29,37 +108,180 @@ public:
     bool initUdpSocket(const SdpStruct& sdp);
 
     /**
-     * 发送 PS 数据包
+     * 取得一个空闲帧（复用已发送帧的缓冲区）
+     */
+    FramePtr acquireFrame();
+
+    /**
+     * 把一帧 PS 数据放入发送队列（任意线程调用，不阻塞），由发送线程按 MTU 分片为多个 RTP 包（同一时间戳）发送
+     *
+     * 负载不拷贝：每个 RTP 包由 RTP 头 + 若干分段切片组成，一次 sendmsg 交给内核。
+     * 不超过一个 RTP 包的分段（如 MTU 条带）在当前包放不下时另起一个包，尽量不跨包，丢一个包只影响一个条带。
+     * 每帧最后一个 RTP 包置 marker。
      *
-     * @param pkt 数据包
-     * @param pkt_len 数据包长度
-     * @param is_end 数据包是否结束
-     * @param timestamp 时间戳
+     * 队列超过 RTP_SEND_QUEUE_MAX_BYTES / RTP_SEND_QUEUE_MAX_FRAMES 时：
+     * 1. 先丢弃排队中的非参考帧和音频帧；
+     * 2. 仍放不下：IDR 帧入队并丢弃排队中的全部视频帧；其他帧丢弃排队中的非 IDR 视频帧和本帧，
+     *    之后丢弃视频帧直到下一个 IDR，并通过回调请求关键帧
      */
-    void sendDataPacket(const uint8_t* pkt, size_t pkt_len, bool is_end, uint32_t timestamp);
+    void enqueueFrame(FramePtr frame);
+
+    /**
+     * 发送队列因丢参考帧需要尽快得到 IDR 时回调（在调用 enqueueFrame 的线程中）
+     */
+    void setKeyFrameRequestCallback(const std::function<void()>& callback);
 
     void stop();
 
+    /**
+     * 采样当前发送通道状态（TCP_INFO / SIOCOUTQ / 发送错误计数）
+     */
+    NetworkStats networkStats() const;
+
+    SendQueueStats sendQueueStats();
+
     ~RtpSender();
 
 private:
-    static constexpr size_t MAX_RTP_PAYLOAD = 1400;                // 单个 PS 包的最大尺寸
-    static constexpr size_t MAX_RTP_PACKET = 12 + MAX_RTP_PAYLOAD; // 完整 RTP 包最大长度（1412）
+    static constexpr size_t MAX_RTP_PAYLOAD = RTP_MAX_PAYLOAD; // 单个 RTP 包的最大负载（PS 分片）
+    static constexpr size_t RTP_HEADER_SIZE = 12;
+    // 单个 RTP 包的 iovec 上限：RTP 头（TCP 时连同分帧头）+ 负载切片
+    static constexpr size_t MAX_IOV_PER_PACKET = 16;
+    // TCP 分帧头长度：RFC 4571 为 2 字节长度，RTSP interleaved 为 $ + 通道 + 2 字节长度
+    static constexpr size_t TCP_FRAMING_SIZE = RTP_TCP_FRAMING_RFC4571 ? 2 : 4;
+    // 等待可写的单次超时，超时后检查是否已停止发送
+    static constexpr int WRITABLE_WAIT_MS = 100;
+    // 发送队列统计日志间隔
+    static constexpr int64_t QUEUE_STATS_LOG_INTERVAL_US = 30 * 1000000LL;
+    // 批量发送：单次 sendmmsg（UDP）/ sendmsg（TCP）的 RTP 包数上限，每包至多 MAX_IOV_PER_PACKET 个 iovec，不超过 UIO_MAXIOV
+    static constexpr size_t BATCH_MAX_PACKETS = 64;
+    // 单个 GSO 消息的长度上限（IPv4 UDP 负载上限）和分段数上限（内核 UDP_MAX_SEGMENTS）
+    static constexpr size_t UDP_GSO_MAX_BYTES = 65507;
+    static constexpr size_t UDP_GSO_MAX_SEGMENTS = 64;
+
+    /**
+     * 帧内的切片位置
+     */
+    struct PacketCursor {
+        size_t segment_index = 0;
+        size_t segment_offset = 0;
+    };
+
+    /**
+     * 批量发送中的一个 RTP 包：iovs[iov_index] 为 RTP 头（TCP 时连同分帧头），之后为负载切片
+     */
+    struct BatchPacket {
+        size_t iov_index = 0;
+        size_t iov_count = 0;
+        size_t len = 0;
+    };
+
+    /**
+     * 批量发送中的一个消息：单个 RTP 包，或连续多个 RTP 包组成的 GSO 消息（除最后一个外长度都等于 segment_size）
+     */
+    struct BatchMessage {
+        size_t first_packet = 0;
+        size_t packet_count = 0;
+        size_t segment_size = 0;
+        size_t bytes = 0;
+        bool is_closed = false; // 最后一个包短于 segment_size，不能再追加
+    };
+
+    /**
+     * 一批 RTP 包的头部、iovec 和消息（UDP 为 mmsghdr，GSO 消息带 UDP_SEGMENT 控制消息）
+     */
+    struct BatchBuffers {
+        uint8_t headers[BATCH_MAX_PACKETS][TCP_FRAMING_SIZE + RTP_HEADER_SIZE]{};
+        iovec iovs[BATCH_MAX_PACKETS * MAX_IOV_PER_PACKET]{};
+        BatchPacket packets[BATCH_MAX_PACKETS]{};
+        BatchMessage messages[BATCH_MAX_PACKETS]{};
+        mmsghdr msgs[BATCH_MAX_PACKETS]{};
+        alignas(cmsghdr) uint8_t cmsgs[BATCH_MAX_PACKETS][CMSG_SPACE(sizeof(uint16_t))]{};
+        size_t packet_count = 0;
+        size_t message_count = 0;
+    };
+
+    /**
+     * 内核仍在引用的一帧（io_uring 请求未完成 / MSG_ZEROCOPY 未收到完成通知）：帧（含负载引用）和各批头部、消息保持有效
+     */
+    struct InFlightFrame {
+        FramePtr frame;
+        std::vector<std::unique_ptr<BatchBuffers>> batches;
+        size_t pending = 0;           // 未完成的 io_uring 请求数 / 零拷贝发送数
+        bool is_prepared = false;     // 全部请求已发出，pending 归零即可回收
+        uint32_t first_zerocopy_id = 0; // 零拷贝：第一次发送的通知序号，本帧占用 [first, first + zerocopy_count)
+        uint32_t zerocopy_count = 0;
+    };
+
+    // io_uring SQ 长度（CQ 为其两倍，未完成请求数不超过 SQ 长度，CQ 不会溢出）
+    static constexpr unsigned URING_ENTRIES = 256;
+    // 请求的 user_data 低位标记 GSO 消息（InFlightFrame 至少 8 字节对齐）
+    static constexpr uint64_t URING_GSO_FLAG = 1;
+    // 停止发送时等待未完成请求 / 零拷贝通知的时长上限
+    static constexpr int64_t IN_FLIGHT_DRAIN_TIMEOUT_US = 1000000;
+    // 空闲批缓冲区个数上限（约 26KB 一个）
+    static constexpr size_t FREE_BATCHES_MAX = 32;
 
     Logger _logger;
 
+    // 控制线程创建 / 关闭 socket 时持有 _socket_mutex，码率控制线程读取统计也持有它，
+    // 避免读到已关闭（甚至被复用）的描述符；发送线程只在 socket 不变的运行期间访问，不加锁
+    mutable std::mutex _socket_mutex{};
     int _rtp_socket = -1;
     bool _is_tcp = false;
 
     // udp 目标地址
     sockaddr_in _remote_addr{};
 
-    std::mutex _buffer_mutex{};
-    uint8_t _rtp_buffer[MAX_RTP_PACKET]{};
+    // RTP 头，只由发送线程访问
+    uint8_t _rtp_header[RTP_HEADER_SIZE]{};
     uint32_t _ssrc = 0x12345678;
     uint16_t _seq = 0;
     uint8_t _payload_type = 96; // PS流的 payload type
 
+    std::atomic<uint64_t> _would_block_count{0};
+    std::atomic<uint64_t> _send_error_count{0};
+
+    // 批量发送，缓冲区只由发送线程访问
+    bool _is_batch_enabled = false;
+    bool _is_gso_enabled = false;
+    BatchBuffers _batch{};
+
+    // 内核仍在引用的帧，只由发送线程访问
+    std::vector<std::unique_ptr<InFlightFrame>> _free_in_flight_frames{};
+    std::vector<std::unique_ptr<BatchBuffers>> _free_batches{};
+
+    // io_uring 发送（UDP），只由发送线程访问
+    bool _is_uring_enabled = false;
+    IoUring _uring;
+    size_t _uring_pending = 0;                                     // 已放入 SQ 但未完成的请求数
+    io_uring_sqe* _uring_last_sqe = nullptr;                       // 尚未提交的最后一个请求，提交前断开链接
+    std::vector<std::unique_ptr<InFlightFrame>> _uring_frames{};   // 未完成的帧
+
+    // TCP 零拷贝发送，只由发送线程访问
+    bool _is_zerocopy_enabled = false;
+    uint32_t _zerocopy_next_id = 0;                                // 下一次零拷贝发送的通知序号（内核按成功的发送调用计数）
+    std::vector<std::unique_ptr<InFlightFrame>> _zerocopy_frames{}; // 未收到完成通知的帧
+    std::atomic<uint64_t> _zerocopy_sent_frames{0};
+    std::atomic<uint64_t> _zerocopy_copied{0};
+
+    // 发送线程与有界队列
+    std::unique_ptr<std::thread> _sender_thread_ptr = nullptr;
+    int _epoll_fd = -1;
+    mutable std::mutex _queue_mutex{};
+    std::condition_variable _queue_cv{};
+    std::deque<FramePtr> _queue{};
+    std::vector<FramePtr> _free_frames{};
+    bool _is_sending = false;
+    bool _is_waiting_for_key = false; // 丢过参考帧，视频帧丢弃到下一个 IDR
+    std::function<void()> _key_frame_request_callback;
+    SendQueueStats _queue_stats{};
+    std::atomic<uint64_t> _stalls{0};
+    std::atomic<uint64_t> _stall_us{0};
+    std::atomic<uint64_t> _sent_packets{0};
+    std::atomic<uint64_t> _send_calls{0};
+    int64_t _last_stats_log_us = 0; // 只由发送线程访问
+
     /**
      * 初始化 SSRC 和 Seq
      *
@@ -68,12 +290,200 @@ private:
     void init_ssrc_seq(const std::string& ssrc);
 
     /**
-     * 发送 RTP 包
+     * 创建 socket 并记录传输类型（调用前发送线程已停止）
+     */
+    bool open_socket(bool is_tcp);
+
+    /**
+     * 关闭 socket（调用前发送线程已停止）
+     */
+    void close_socket();
+
+    /**
+     * 创建 epoll 并启动发送线程（socket 初始化成功后调用）
+     */
+    void start_sender();
+
+    /**
+     * 停止发送线程并清空队列
+     */
+    void stop_sender();
+
+    void sender_loop();
+
+    /**
+     * 发送一帧（发送线程），发送完成后回收；内核仍引用负载时（io_uring / 零拷贝）转为 InFlightFrame，完成后回收
+     */
+    void send_frame(FramePtr frame);
+
+    /**
+     * 逐包 sendmsg 发送 UDP 帧（发送线程）
+     */
+    void send_frame_packets(const Frame& frame);
+
+    /**
+     * 帧发送结束：计数并回收
+     */
+    void finish_frame(FramePtr frame);
+
+    /**
+     * UDP 按帧批量发送（发送线程）
+     */
+    void send_frame_batched(const Frame& frame);
+
+    /**
+     * TCP 按帧合并写（发送线程）
+     *
+     * @param zerocopy_frame 非空时以 MSG_ZEROCOPY 发送，每批头部使用独立的缓冲区并由 zerocopy_frame 持有到完成通知
+     */
+    void send_frame_tcp(const Frame& frame, InFlightFrame* zerocopy_frame = nullptr);
+
+    /**
+     * TCP 零拷贝发送一帧（发送线程），帧的所有权交给 _zerocopy_frames，收到全部完成通知后回收
+     */
+    void send_frame_zerocopy(FramePtr frame);
+
+    /**
+     * 读取错误队列中的零拷贝完成通知，回收全部发送都已完成的帧
+     *
+     * @return 读到的通知个数
+     */
+    size_t reap_zerocopy();
+
+    /**
+     * 停止发送时等待零拷贝完成通知，超时后直接回收（页面由内核引用，不会访问已释放的内存）
+     */
+    void drain_zerocopy();
+
+    /**
+     * 取一个空闲的 InFlightFrame / 批缓冲区
+     */
+    std::unique_ptr<InFlightFrame> acquire_in_flight_frame(FramePtr frame);
+
+    std::unique_ptr<BatchBuffers> acquire_batch();
+
+    /**
+     * 内核不再引用帧：从 frames 中移除，回收帧和批缓冲区
+     */
+    void complete_in_flight_frame(std::vector<std::unique_ptr<InFlightFrame>>& frames, InFlightFrame* in_flight);
+
+    /**
+     * 从 cursor 处切出一批 UDP 消息（连续等长的 RTP 包合并为 GSO 消息）并填好 mmsghdr
+     *
+     * @param sent_len 已切出的负载长度，返回时累加本批
+     */
+    void build_udp_batch(const Frame& frame, PacketCursor& cursor, size_t& sent_len, BatchBuffers& batch);
+
+    /**
+     * io_uring 发送一帧（发送线程），帧的所有权交给 io_uring，全部请求完成后回收
+     */
+    void send_frame_uring(FramePtr frame);
+
+    /**
+     * 取一个空闲 SQE，SQ 已满时先提交并等待完成事件
+     *
+     * @return io_uring 出错时返回 nullptr
+     */
+    io_uring_sqe* next_uring_sqe();
+
+    /**
+     * 提交已填充的请求并等待至少 wait_nr 个完成事件，出错时关闭 io_uring 发送（回退到 sendmmsg）
+     */
+    bool submit_uring(unsigned wait_nr, int timeout_ms = -1);
+
+    /**
+     * 回收已完成的请求，帧的请求全部完成后回收帧
+     */
+    void reap_uring();
+
+    /**
+     * 等待未完成的请求，wait_for_all 为 false 时只在发送队列为空时等待（有新帧时先发送新帧）
+     */
+    void drain_uring(bool wait_for_all);
+
+    /**
+     * 从帧的分段中切出下一个 RTP 包的负载（只记录指针，不拷贝）
+     *
+     * @param cursor 切片位置，返回时指向下一个包的起点
+     * @param iov 输出的负载切片
+     * @param max_iov iov 容量
+     * @param iov_count 输出的切片个数
+     * @return 负载长度
+     */
+    size_t slice_packet(const Frame& frame, PacketCursor& cursor, iovec* iov, size_t max_iov, size_t& iov_count) const;
+
+    /**
+     * sendmmsg 发送已切好的 message_count 个消息，GSO 不可用时关闭 GSO 并把剩余的包逐个发送
+     *
+     * @return 停止发送时返回 false
+     */
+    bool send_batch(BatchBuffers& batch);
+
+    /**
+     * 等待 socket 可写（TCP 启用 TCP_NOTSENT_LOWAT 后表示内核中未发出的数据低于阈值），停止发送时返回 false
+     */
+    bool wait_writable();
+
+    /**
+     * 处理 epoll 事件：零拷贝完成通知也以 EPOLLERR 报告，读出通知后按 EPOLLOUT 判断是否可写
+     */
+    bool check_writable(uint32_t events);
+
+    /**
+     * 队列加入该帧后是否超限（调用方持有 _queue_mutex）
+     *
+     * GOP 回放的帧不受上限约束，也不占用实时帧的额度：回放（跨度至多 GOP_REPLAY_MAX_MS）一次性入队，
+     * 以 IDR 开头的突发计入上限会让回放本身触发按 GOP 丢帧和强制 IDR
+     */
+    bool is_queue_full(const Frame& frame) const;
+
+    /**
+     * 帧离开队列（发送或丢弃），更新排队统计（调用方持有 _queue_mutex）
+     */
+    void on_dequeued(const Frame& frame);
+
+    /**
+     * 丢弃排队中满足条件的帧（调用方持有 _queue_mutex）
+     */
+    void drop_queued(const std::function<bool(const Frame&)>& predicate, uint64_t& counter);
+
+    /**
+     * 回收帧（调用方持有 _queue_mutex）
+     */
+    void recycle_frame(FramePtr frame);
+
+    void log_queue_stats();
+
+    /**
+     * 填充 RTP 头（序号取当前 _seq）
+     */
+    void write_rtp_header(uint8_t* dst, bool is_marker, uint32_t timestamp) const;
+
+    /**
+     * 填充 TCP 分帧头（RTP_TCP_FRAMING_RFC4571）
      *
-     * @param rtp_packet RTP 包
      * @param rtp_len RTP 包长度
+     * @return 分帧头长度
+     */
+    static size_t write_tcp_framing(uint8_t* dst, size_t rtp_len);
+
+    /**
+     * TCP 写入一批数据，部分写入时继续写完剩余部分（否则 TCP 流错位）
+     *
+     * @param has_more 本帧还有后续数据，使用 MSG_MORE 让内核攒满报文段再发
+     * @param zerocopy_frame 非空时使用 MSG_ZEROCOPY，每次成功的发送调用占用一个通知序号，记入 zerocopy_frame
+     * @return 发送失败或停止发送时返回 false，本帧剩余部分不再发送
+     */
+    bool send_tcp(iovec* iov, size_t iov_count, size_t total_len, bool has_more,
+                  InFlightFrame* zerocopy_frame = nullptr);
+
+    /**
+     * 发送单个 UDP RTP 包
+     *
+     * @param iov RTP 头和负载切片
+     * @return 停止发送时返回 false，单个包发送失败只计数
      */
-    void send_packet(const uint8_t* rtp_packet, size_t rtp_len);
+    bool send_udp_packet(iovec* iov, size_t iov_count, size_t rtp_len);
 };
 
 #endif //GB28181CONSOLE_RTP_SENDER_HPP
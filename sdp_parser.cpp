@@ -57,6 +57,22 @@ SdpStruct SdpParser::parse(const std::string& sdp) {
         }
     }
 
+    // 码流编号【a=streamnumber:1】，部分平台使用【a=streamprofile:1】，0 = 主码流，1 = 子码流
+    _sdp_struct.stream_number = -1;
+    std::regex stream_regex(R"(a=stream(?:number|profile):(\d+))");
+    std::smatch stream_match;
+    if (std::regex_search(sdp, stream_match, stream_regex) && stream_match.size() > 1) {
+        _sdp_struct.stream_number = std::stoi(stream_match[1].str());
+    }
+
+    // f= 字段视频编码格式【f=v/5/6/25/1/4096a/1/8/1】：v/编码格式/分辨率/帧率/码率类型/码率大小a/...
+    _sdp_struct.video_format = -1;
+    std::regex f_regex(R"(f=v/(\d+))");
+    std::smatch f_match;
+    if (std::regex_search(sdp, f_match, f_regex) && f_match.size() > 1) {
+        _sdp_struct.video_format = std::stoi(f_match[1].str());
+    }
+
     // y= 字段（GB28181 SSRC）【y=0108000147】
     std::regex y_regex(R"(y=(\S+))");
     std::smatch y_match;
@@ -85,7 +101,7 @@ SdpStruct SdpParser::parse(const std::string& sdp) {
  *  - P2P通话: 双向实时通信，双方角色对等
  * */
 std::string SdpParser::buildUpstreamSdp(const std::string& device_code, const std::string& local_ip,
-                                        const std::string& ssrc) {
+                                        const std::string& ssrc, const int video_format) {
     std::ostringstream oss;
     //o=<username> <sess-id> <sess-version> IN IP4 <unicast-address>
     oss << "v=0\r\n";
@@ -97,7 +113,8 @@ std::string SdpParser::buildUpstreamSdp(const std::string& device_code, const st
             << "a=sendonly\r\n"
             << "a=rtpmap:96 PS/90000\r\n"
             << "a=connection:new\r\n"
-            << "y=" << ssrc << "\r\n";
+            << "y=" << ssrc << "\r\n"
+            << "f=v/" << video_format << "////a///\r\n"; // 只声明视频编码格式，其余字段留空
 
     std::string result = oss.str();
 
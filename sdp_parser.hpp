@@ -19,6 +19,8 @@ struct SdpStruct {
     std::string transport = "tcp";      // "udp" or "tcp"
     std::string ssrc;                   // 流标识
     std::string setup;                  // 被动/主动
+    int stream_number = -1;             // 码流编号（a=streamnumber / a=streamprofile），-1 表示未指定
+    int video_format = -1;              // f= 行视频编码格式（2 = H.264，5 = H.265），-1 表示未指定
 };
 
 class SdpParser {
@@ -41,10 +43,12 @@ public:
      * @param device_code 设备编码
      * @param local_ip
      * @param ssrc 流标识
+     * @param video_format f= 行视频编码格式（2 = H.264，5 = H.265）
      */
     std::string buildUpstreamSdp(const std::string& device_code,
                                  const std::string& local_ip,
-                                 const std::string& ssrc);
+                                 const std::string& ssrc,
+                                 int video_format);
 
     /**
      * 构建下行音频 SDP Answer
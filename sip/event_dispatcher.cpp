@@ -260,6 +260,9 @@ void EventDispatcher::process_message_event(const eXosip_event_t* event) {
     } else if (root_name == "Notify") {
         _logger.i("处理通知类消息");
         process_notify_message(xml);
+    } else if (root_name == "Control") {
+        _logger.i("处理控制类消息");
+        process_control_message(xml);
     } else {
         _logger.wFmt("未知的消息类型: %s", root_name.c_str());
     }
@@ -351,6 +354,44 @@ void EventDispatcher::process_query_message(const pugi::xml_document& xml) {
     }
 }
 
+void EventDispatcher::process_control_message(const pugi::xml_document& xml) {
+    const pugi::xml_node control_node = xml.child("Control");
+    if (!control_node) {
+        _logger.e("XML 中未找到 Control 节点");
+        return;
+    }
+
+    const pugi::xml_node cmd_type_node = control_node.child("CmdType");
+    const pugi::xml_node sn_node = control_node.child("SN");
+    if (!cmd_type_node || !sn_node) {
+        _logger.e("缺少必要字段 (CmdType 或 SN)");
+        return;
+    }
+
+    const std::string cmd_type = cmd_type_node.text().as_string();
+    const std::string sn = sn_node.text().as_string();
+    _logger.dBox()
+           .add("收到控制命令")
+           .addFmt("CmdType: %s", cmd_type.c_str())
+           .addFmt("SN: %s", sn.c_str())
+           .print();
+
+    if (cmd_type != "DeviceControl") {
+        _logger.wFmt("不支持的控制类型: %s", cmd_type.c_str());
+        return;
+    }
+
+    // 强制关键帧：标准中字段名为 IFameCmd（部分平台写作 IFrameCmd），属于无应答命令
+    if (control_node.child("IFameCmd") || control_node.child("IFrameCmd")) {
+        _logger.i("收到强制关键帧请求");
+        if (_media_observer_ptr) {
+            _media_observer_ptr->onKeyFrameRequest();
+        }
+        return;
+    }
+    _logger.w("暂不支持的设备控制命令");
+}
+
 void EventDispatcher::process_notify_message(const pugi::xml_document& xml) {
     const pugi::xml_node notify_node = xml.child("Notify");
     if (!notify_node) {
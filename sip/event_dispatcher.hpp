@@ -37,6 +37,11 @@ public:
     virtual void onStartReceiveAudio(eXosip_event_t* event) = 0;
 
     virtual void onMediaClosed(int cid) = 0;
+
+    /**
+     * 平台下发强制关键帧（DeviceControl / IFameCmd）
+     */
+    virtual void onKeyFrameRequest() = 0;
 };
 
 class EventDispatcher {
@@ -114,6 +119,8 @@ private:
 
     void process_notify_message(const pugi::xml_document& xml);
 
+    void process_control_message(const pugi::xml_document& xml);
+
     // ============================================================
     // 给平台发送消息的相关函数
     // ============================================================
@@ -190,6 +190,10 @@ void SipManager::onMediaClosed(const int cid) {
     _stream_manager_ptr->callClosed(cid);
 }
 
+void SipManager::onKeyFrameRequest() {
+    _sip_state_callback(2111, StateCode::toString(2111));
+}
+
 void SipManager::onG711DataReceived(uint8_t* g711, const size_t len) {
     _g711_data_callback(g711, len);
 }
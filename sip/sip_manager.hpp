@@ -62,6 +62,8 @@ public:
 
     void onMediaClosed(int cid) override;
 
+    void onKeyFrameRequest() override;
+
     // ============================================================
     // IStreamObserver 接口实现
     // ============================================================
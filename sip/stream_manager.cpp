@@ -7,6 +7,7 @@
 #include "response_sender.hpp"
 #include "rtp_sender.hpp"
 #include "state_code.hpp"
+#include "video/video_profile.hpp"
 #include "audio/audio_processor.hpp"
 
 StreamManager::StreamManager(SipContext* context, IStreamObserver* observer) : _logger("StreamManager"),
@@ -61,6 +62,12 @@ void StreamManager::handleVideoInvite(eXosip_event_t* event) {
         return;
     }
 
+    // 选择推送的编码档位（主/子码流），并通知上层提前唤醒该档位编码器：
+    // 建立 RTP 连接、回复 200 OK 期间编码器已经在产出 IDR，会话开始时直接从 GOP 缓存起播
+    VideoProfiles::get()->select(parse_stream_number(subject, sdp_struct));
+    const VideoCodec codec = VideoProfiles::get()->selectCodec(parse_video_codec(sdp_struct));
+    _stream_observer_ptr->onStreamStateChanged(2110, StateCode::toString(2110));
+
     _logger.i("初始化 RTP 发送器...");
     bool init_socket_success = false;
     if (sdp_struct.transport == "udp") {
@@ -78,7 +85,8 @@ void StreamManager::handleVideoInvite(eXosip_event_t* event) {
     const auto parameter = _sip_context_ptr->getSipParameter();
     std::string sdp_answer = SdpParser::get()->buildUpstreamSdp(parameter.deviceCode,
                                                                 parameter.localHost,
-                                                                sdp_struct.ssrc);
+                                                                sdp_struct.ssrc,
+                                                                codec == VideoCodec::H265 ? 5 : 2);
     if (sdp_answer.empty()) {
         _stream_observer_ptr->onStreamStateChanged(2103, StateCode::toString(2103));
         send_sip_call_error_response(event->tid, 500, StateCode::toString(2103));
@@ -363,4 +371,38 @@ void StreamManager::reset() {
 // ============================================================
 bool StreamManager::send_sip_call_error_response(const int tid, const int code, const std::string& reason) const {
     return ResponseSender::get()->sendCallErrorResponse(_sip_context_ptr, tid, code, reason);
-}
\ No newline at end of file
+}
+
+VideoCodec StreamManager::parse_video_codec(const SdpStruct& sdp) {
+    switch (sdp.video_format) {
+        case 2:
+            return VideoCodec::H264;
+        case 5:
+            return VideoCodec::H265;
+        default:
+            // 未指定或不支持的格式（MPEG-4 / SVAC 等）使用默认编码格式
+            return VideoProfiles::get()->defaultCodec();
+    }
+}
+
+int StreamManager::parse_stream_number(const osip_header_t* subject, const SdpStruct& sdp) {
+    if (sdp.stream_number >= 0) {
+        return sdp.stream_number;
+    }
+    if (!subject || !subject->hvalue) {
+        return -1;
+    }
+
+    // 34020000001320000001:1,34020000002000000001:0 -> 1
+    const std::string value = subject->hvalue;
+    const size_t colon = value.find(':');
+    if (colon == std::string::npos) {
+        return -1;
+    }
+    const size_t end = value.find(',', colon);
+    const std::string sequence = value.substr(colon + 1, end == std::string::npos ? std::string::npos : end - colon - 1);
+    if (sequence.empty() || sequence.find_first_not_of("0123456789") != std::string::npos || sequence.size() > 4) {
+        return -1;
+    }
+    return std::stoi(sequence);
+}
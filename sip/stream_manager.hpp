@@ -8,7 +8,9 @@
 #include <mutex>
 
 #include "audio/audio_receiver.hpp"
+#include "sdp_parser.hpp"
 #include "sip_context.hpp"
+#include "video/video_codec.hpp"
 
 class IStreamObserver {
 public:
@@ -68,6 +70,20 @@ private:
     // 给平台发送消息的相关函数
     // ============================================================
     bool send_sip_call_error_response(int tid, int code, const std::string& reason) const;
+
+    /**
+     * 解析点播的码流编号：优先 SDP 中的 a=streamnumber，其次 Subject 中发送方媒体流序列号
+     *
+     * Subject 格式：媒体流发送者ID:发送方媒体流序列号,媒体流接收者ID:接收方媒体流序列号
+     *
+     * @return 码流编号，未指定时返回 -1
+     */
+    static int parse_stream_number(const osip_header_t* subject, const SdpStruct& sdp);
+
+    /**
+     * 解析平台要求的视频编码格式（SDP f= 行），未指定时使用默认编码格式
+     */
+    static VideoCodec parse_video_codec(const SdpStruct& sdp);
 };
 
 #endif //GB28181CONSOLE_STREAM_MANAGER_HPP
\ No newline at end of file
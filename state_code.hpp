@@ -340,6 +340,10 @@ public:
                 return "GB_STREAM_TIMEOUT (推流超时)";
             case 2109:
                 return "GB_STREAM_PORT_ALLOC_FAILED (RTP端口分配失败)";
+            case 2110:
+                return "GB_STREAM_INVITE_RECEIVED (收到点播请求，预热编码器)";
+            case 2111:
+                return "GB_STREAM_KEYFRAME_REQUEST (平台请求强制关键帧)";
 
             // ==========================================
             // 2200-2299: GB28181 语音对讲相关错误码
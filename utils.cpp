@@ -4,22 +4,70 @@
 
 #include "utils.hpp"
 
+#include <cstring>
+#include <pthread.h>
+#include <sched.h>
+
 Utils::Utils() : _logger("Utils") {
     _logger.i("Utils created");
 }
 
-uint32_t Utils::calculateCRC32(const std::vector<uint8_t>& data, const size_t start, const size_t length) { // NOLINT
-    uint32_t crc = 0xFFFFFFFF;
-    for (size_t i = start; i < start + length; ++i) {
-        crc ^= data[i];
+namespace {
+/**
+ * slicing-by-8 查表：table[0] 为逐字节查表，table[k][i] 为字节 i 之后再经过 k 个零字节的 CRC
+ */
+struct Crc32Tables {
+    uint32_t table[8][256];
+};
+
+constexpr Crc32Tables makeCrc32Tables() {
+    Crc32Tables tables{};
+    for (uint32_t i = 0; i < 256; ++i) {
+        uint32_t crc = i;
         for (int j = 0; j < 8; ++j) {
-            if (crc & 1) {
-                crc = (crc >> 1) ^ 0xEDB88320;
-            } else {
-                crc >>= 1;
-            }
+            crc = (crc & 1) ? (crc >> 1) ^ 0xEDB88320 : crc >> 1;
+        }
+        tables.table[0][i] = crc;
+    }
+    for (uint32_t i = 0; i < 256; ++i) {
+        for (int k = 1; k < 8; ++k) {
+            const uint32_t prev = tables.table[k - 1][i];
+            tables.table[k][i] = (prev >> 8) ^ tables.table[0][prev & 0xFF];
         }
     }
+    return tables;
+}
+
+constexpr Crc32Tables CRC32_TABLES = makeCrc32Tables();
+
+inline uint32_t loadLe32(const uint8_t* data) {
+    return static_cast<uint32_t>(data[0]) | static_cast<uint32_t>(data[1]) << 8 |
+           static_cast<uint32_t>(data[2]) << 16 | static_cast<uint32_t>(data[3]) << 24;
+}
+} // namespace
+
+uint32_t Utils::calculateCRC32(const std::vector<uint8_t>& data, const size_t start, const size_t length) { // NOLINT
+    if (start + length > data.size()) {
+        return 0;
+    }
+    return calculateCRC32(data.data() + start, length);
+}
+
+uint32_t Utils::calculateCRC32(const uint8_t* data, size_t length) {
+    const auto& t = CRC32_TABLES.table;
+    uint32_t crc = 0xFFFFFFFF;
+
+    while (length >= 8) {
+        const uint32_t one = loadLe32(data) ^ crc;
+        const uint32_t two = loadLe32(data + 4);
+        crc = t[7][one & 0xFF] ^ t[6][(one >> 8) & 0xFF] ^ t[5][(one >> 16) & 0xFF] ^ t[4][one >> 24] ^
+              t[3][two & 0xFF] ^ t[2][(two >> 8) & 0xFF] ^ t[1][(two >> 16) & 0xFF] ^ t[0][two >> 24];
+        data += 8;
+        length -= 8;
+    }
+    while (length-- > 0) {
+        crc = (crc >> 8) ^ t[0][(crc ^ *data++) & 0xFF];
+    }
     return crc ^ 0xFFFFFFFF;
 }
 
@@ -44,4 +92,19 @@ std::string Utils::bytesToHex(const std::vector<uint8_t> &data, size_t length) {
         if (i < len - 1) str += " ";  // 只在中间加空格，末尾不加
     }
     return str;
-}
\ No newline at end of file
+}
+
+bool Utils::bindThreadToCpu(std::thread& thread, const int cpu) {
+    if (cpu < 0) {
+        return true;
+    }
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    CPU_SET(cpu, &cpu_set);
+    const int ret = pthread_setaffinity_np(thread.native_handle(), sizeof(cpu_set_t), &cpu_set);
+    if (ret != 0) {
+        _logger.eFmt("Bind thread to CPU %d failed: %s", cpu, strerror(ret));
+        return false;
+    }
+    return true;
+}
@@ -8,6 +8,7 @@
 #include <cstdint>
 #include <random>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include "logger.hpp"
@@ -25,12 +26,39 @@ public:
 
     Utils& operator=(const Utils&) = delete;
 
+    /**
+     * PSM 使用的 CRC-32（多项式 0xEDB88320，初值/结果异或 0xFFFFFFFF），查表实现（slicing-by-8，每次处理 8 字节）
+     */
     uint32_t calculateCRC32(const std::vector<uint8_t>& data, size_t start, size_t length);
 
+    static uint32_t calculateCRC32(const uint8_t* data, size_t length);
+
+    /**
+     * 与 calculateCRC32 结果相同的逐位实现，供编译期生成固定头部使用
+     */
+    static constexpr uint32_t calculateCRC32Bitwise(const uint8_t* data, const size_t length) {
+        uint32_t crc = 0xFFFFFFFF;
+        for (size_t i = 0; i < length; ++i) {
+            crc ^= data[i];
+            for (int j = 0; j < 8; ++j) {
+                crc = (crc & 1) ? (crc >> 1) ^ 0xEDB88320 : crc >> 1;
+            }
+        }
+        return crc ^ 0xFFFFFFFF;
+    }
+
     std::string randomSsrc();
 
     std::string bytesToHex(const std::vector<uint8_t>& data, size_t length);
 
+    /**
+     * 把线程绑定到指定 CPU 核
+     *
+     * @param cpu CPU 编号，小于 0 表示不绑定
+     * @return 是否绑定成功（不绑定时返回 true）
+     */
+    bool bindThreadToCpu(std::thread& thread, int cpu);
+
 private:
     Logger _logger;
     std::random_device _rd;
@@ -0,0 +1,169 @@
+//
+// Created by pengx on 2026/10/16.
+//
+
+#include "bitrate_controller.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+// 拥塞时的降码率系数
+static constexpr double DECREASE_FACTOR = 0.7;
+// 恢复时每步增加标称码率的比例
+static constexpr double INCREASE_STEP = 0.1;
+// 最低码率（相对标称码率），再低画面已无意义
+static constexpr double MIN_RATIO = 0.2;
+// 连续畅通多少个周期后才开始恢复（迟滞，避免在临界带宽附近来回振荡）
+static constexpr int RECOVER_INTERVALS = 6;
+// 码率变化小于该比例时不重新配置编码器
+static constexpr double APPLY_THRESHOLD = 0.05;
+// 发送队列积压超过多长时间的数据量视为拥塞（秒）
+static constexpr double QUEUE_HIGH_SECONDS = 0.25;
+// RTT 超过最小 RTT 的倍数 + 余量视为排队时延上升
+static constexpr uint32_t RTT_FACTOR = 2;
+static constexpr uint32_t RTT_MARGIN_US = 30000;
+
+BitrateController::BitrateController(const int interval_ms) : _logger("BitrateController"),
+                                                              _interval_ms(interval_ms) {
+    _logger.i("BitrateController created");
+}
+
+BitrateController::~BitrateController() {
+    stop();
+}
+
+void BitrateController::setCallback(BitrateCallback callback) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _callback = std::move(callback);
+}
+
+void BitrateController::reset(const int64_t nominal_bps) {
+    _target_bps.store(nominal_bps, std::memory_order_relaxed);
+    _reset_bps.store(nominal_bps, std::memory_order_release);
+}
+
+bool BitrateController::start() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_is_running.load()) {
+        _logger.w("BitrateController already running");
+        return false;
+    }
+    if (!_callback) {
+        _logger.e("Bitrate callback not set");
+        return false;
+    }
+    _is_running = true;
+    _thread_ptr = std::make_unique<std::thread>(&BitrateController::control_loop, this);
+    return true;
+}
+
+void BitrateController::stop() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (!_is_running.load()) {
+        return;
+    }
+    _is_running = false;
+    if (_thread_ptr && _thread_ptr->joinable()) {
+        _thread_ptr->join();
+    }
+    _thread_ptr.reset();
+}
+
+void BitrateController::control_loop() {
+    while (_is_running.load()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(_interval_ms));
+
+        // 新会话：恢复标称码率，重新学习最小 RTT
+        const int64_t reset_bps = _reset_bps.exchange(0, std::memory_order_acquire);
+        if (reset_bps > 0) {
+            _nominal_bps = reset_bps;
+            _applied_bps = reset_bps;
+            _clean_intervals = 0;
+            _min_rtt_us = 0;
+            _last_stats = RtpSender::get()->networkStats();
+            continue;
+        }
+
+        const auto stats = RtpSender::get()->networkStats();
+        if (!stats.is_open || _nominal_bps <= 0) {
+            _last_stats = stats;
+            continue;
+        }
+
+        const char* reason = nullptr;
+        const bool is_congested = this->is_congested(stats, reason);
+        _last_stats = stats;
+
+        const int64_t min_bps = static_cast<int64_t>(static_cast<double>(_nominal_bps) * MIN_RATIO);
+        int64_t target_bps = _target_bps.load(std::memory_order_relaxed);
+        if (is_congested) {
+            _clean_intervals = 0;
+            target_bps = std::max(min_bps, static_cast<int64_t>(static_cast<double>(target_bps) * DECREASE_FACTOR));
+        } else if (target_bps < _nominal_bps && ++_clean_intervals >= RECOVER_INTERVALS) {
+            _clean_intervals = 0;
+            target_bps = std::min(_nominal_bps,
+                                  target_bps + static_cast<int64_t>(static_cast<double>(_nominal_bps) * INCREASE_STEP));
+            reason = "recovered";
+        }
+        _target_bps.store(target_bps, std::memory_order_relaxed);
+        apply(target_bps, reason);
+    }
+}
+
+bool BitrateController::is_congested(const RtpSender::NetworkStats& stats, const char*& reason) {
+    // 发送缓冲区满 / UDP 发送失败：上行已经跟不上
+    if (stats.would_block > _last_stats.would_block) {
+        reason = "socket would block";
+        return true;
+    }
+    if (!stats.is_tcp && stats.send_errors > _last_stats.send_errors) {
+        reason = "udp send error";
+        return true;
+    }
+    if (stats.dropped_frames > _last_stats.dropped_frames) {
+        reason = "send queue overflow";
+        return true;
+    }
+
+    // 发送队列 + 内核发送队列积压超过 QUEUE_HIGH_SECONDS 的数据量
+    const double queue_high_bytes = static_cast<double>(_target_bps.load(std::memory_order_relaxed)) / 8 *
+                                    QUEUE_HIGH_SECONDS;
+    if (static_cast<double>(stats.send_queue_bytes) + static_cast<double>(stats.queued_bytes) > queue_high_bytes) {
+        reason = "send queue backlog";
+        return true;
+    }
+
+    // TCP 排队时延：RTT 明显高于会话内观测到的最小 RTT
+    if (stats.is_tcp && stats.rtt_us > 0) {
+        if (_min_rtt_us == 0 || stats.rtt_us < _min_rtt_us) {
+            _min_rtt_us = stats.rtt_us;
+        }
+        if (stats.rtt_us > _min_rtt_us * RTT_FACTOR + RTT_MARGIN_US) {
+            reason = "rtt inflation";
+            return true;
+        }
+    }
+    return false;
+}
+
+void BitrateController::apply(const int64_t target_bps, const char* reason) {
+    // 迟滞：变化足够大，或者回到标称码率时才重新配置编码器
+    const double change = std::abs(static_cast<double>(target_bps - _applied_bps)) / static_cast<double>(_nominal_bps);
+    if (target_bps == _applied_bps || (change < APPLY_THRESHOLD && target_bps != _nominal_bps)) {
+        return;
+    }
+
+    _logger.iFmt("Bitrate %lld -> %lld bps (%s)", static_cast<long long>(_applied_bps),
+                 static_cast<long long>(target_bps), reason ? reason : "");
+    _applied_bps = target_bps;
+
+    BitrateCallback callback;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        callback = _callback;
+    }
+    if (callback) {
+        callback(target_bps);
+    }
+}
@@ -0,0 +1,90 @@
+//
+// Created by pengx on 2026/10/16.
+//
+
+#ifndef GB28181CONSOLE_BITRATE_CONTROLLER_HPP
+#define GB28181CONSOLE_BITRATE_CONTROLLER_HPP
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "logger.hpp"
+#include "rtp_sender.hpp"
+
+/**
+ * 网络自适应码率控制
+ *
+ * 周期采样 RtpSender 的发送通道状态（内核发送队列积压、TCP_INFO 的 RTT、EAGAIN / UDP 发送错误），
+ * 判定为拥塞时乘性降低目标码率，连续若干周期畅通后再加性恢复到标称码率（AIMD + 迟滞），
+ * 让弱网（如 4G 上行）下的表现是短时画质下降，而不是长时间卡死。
+ * */
+class BitrateController {
+public:
+    /**
+     * 目标码率变化回调（bps）
+     */
+    using BitrateCallback = std::function<void(int64_t)>;
+
+    /**
+     * @param interval_ms 采样周期（毫秒）
+     */
+    explicit BitrateController(int interval_ms = 500);
+
+    ~BitrateController();
+
+    BitrateController(const BitrateController&) = delete;
+
+    BitrateController& operator=(const BitrateController&) = delete;
+
+    /**
+     * 设置码率变化回调，必须在 start() 之前调用
+     */
+    void setCallback(BitrateCallback callback);
+
+    /**
+     * 新会话开始时调用：以标称码率重新开始控制
+     *
+     * @param nominal_bps 当前推送档位的标称码率
+     */
+    void reset(int64_t nominal_bps);
+
+    bool start();
+
+    void stop();
+
+    int64_t targetBitRate() const {
+        return _target_bps.load(std::memory_order_relaxed);
+    }
+
+private:
+    Logger _logger;
+    const int _interval_ms;
+
+    std::atomic<bool> _is_running{false};
+    std::unique_ptr<std::thread> _thread_ptr;
+    std::mutex _mutex;
+    BitrateCallback _callback;
+
+    // 以下状态除 _target_bps 外只在控制线程内访问，reset() 通过 _reset_bps 交给控制线程处理
+    std::atomic<int64_t> _reset_bps{0};
+    std::atomic<int64_t> _target_bps{0};
+    int64_t _nominal_bps = 0;
+    int64_t _applied_bps = 0;
+    int _clean_intervals = 0;
+    uint32_t _min_rtt_us = 0;
+    RtpSender::NetworkStats _last_stats{};
+
+    void control_loop();
+
+    /**
+     * 根据本周期的采样判断是否拥塞
+     */
+    bool is_congested(const RtpSender::NetworkStats& stats, const char*& reason);
+
+    void apply(int64_t target_bps, const char* reason);
+};
+
+#endif //GB28181CONSOLE_BITRATE_CONTROLLER_HPP
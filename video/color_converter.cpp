@@ -0,0 +1,151 @@
+//
+// Created by pengx on 2026/10/16.
+//
+
+#include "color_converter.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace {
+// 行带最少行数，小分辨率不值得拆分
+constexpr int MIN_BAND_ROWS = 64;
+} // namespace
+
+ColorConverter::ColorConverter(const int thread_count) : _logger("ColorConverter"), _kernels(bestColorKernels()) {
+    // 工作线程 i 负责行带 i + 1，行带 0 由调用线程处理
+    for (int band = 1; band < thread_count; ++band) {
+        _workers.emplace_back(&ColorConverter::worker_loop, this, band);
+    }
+    _logger.iFmt("ColorConverter created, kernels: %s, threads: %d", _kernels.name,
+                 static_cast<int>(_workers.size()) + 1);
+}
+
+ColorConverter::~ColorConverter() {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _is_running = false;
+    }
+    _start_cv.notify_all();
+    for (auto& worker : _workers) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+}
+
+bool ColorConverter::toI420(const VideoFrame& frame, uint8_t* const dst[3], const int dst_stride[3]) {
+    if (frame.format == PixelFormat::I420 || (frame.width & 1) || (frame.height & 1) || frame.mat.empty()) {
+        return false;
+    }
+
+    Job job;
+    job.format = frame.format;
+    job.src = frame.mat.data;
+    job.src_stride = static_cast<int>(frame.mat.step[0]);
+    for (int i = 0; i < 3; ++i) {
+        job.dst[i] = dst[i];
+        job.dst_stride[i] = dst_stride[i];
+    }
+    job.width = frame.width;
+    job.height = frame.height;
+
+    const int max_bands = static_cast<int>(_workers.size()) + 1;
+    job.band_count = std::max(1, std::min(max_bands, frame.height / MIN_BAND_ROWS));
+
+    if (job.band_count == 1) {
+        convert_band(job, 0);
+        return true;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _job = job;
+        _pending = job.band_count - 1;
+        ++_generation;
+    }
+    _start_cv.notify_all();
+
+    convert_band(job, 0);
+
+    // 等待其余行带完成，返回后调用方即可把目标帧交给编码器
+    std::unique_lock<std::mutex> lock(_mutex);
+    _done_cv.wait(lock, [this] {
+        return _pending == 0;
+    });
+    return true;
+}
+
+void ColorConverter::worker_loop(const int band) {
+    uint64_t seen_generation = 0;
+    while (true) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _start_cv.wait(lock, [this, seen_generation] {
+                return !_is_running || _generation != seen_generation;
+            });
+            if (!_is_running) {
+                return;
+            }
+            seen_generation = _generation;
+            job = _job;
+        }
+
+        // 本帧行带数少于线程数时，多余的线程直接跳过
+        if (band >= job.band_count) {
+            continue;
+        }
+
+        convert_band(job, band);
+
+        bool is_last;
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            is_last = --_pending == 0;
+        }
+        if (is_last) {
+            _done_cv.notify_one();
+        }
+    }
+}
+
+void ColorConverter::convert_band(const Job& job, const int band) const {
+    // 按行对（一行色度）均分，保证每个行带起止行都是偶数
+    const int row_pairs = job.height / 2;
+    const int pair_begin = row_pairs * band / job.band_count;
+    const int pair_end = row_pairs * (band + 1) / job.band_count;
+    const int chroma_width = job.width / 2;
+
+    for (int pair = pair_begin; pair < pair_end; ++pair) {
+        const int row = pair * 2;
+        uint8_t* dst_y0 = job.dst[0] + static_cast<size_t>(row) * job.dst_stride[0];
+        uint8_t* dst_y1 = dst_y0 + job.dst_stride[0];
+        uint8_t* dst_u = job.dst[1] + static_cast<size_t>(pair) * job.dst_stride[1];
+        uint8_t* dst_v = job.dst[2] + static_cast<size_t>(pair) * job.dst_stride[2];
+
+        switch (job.format) {
+            case PixelFormat::BGR24: {
+                const uint8_t* src0 = job.src + static_cast<size_t>(row) * job.src_stride;
+                _kernels.bgr24(src0, src0 + job.src_stride, dst_y0, dst_y1, dst_u, dst_v, job.width);
+                break;
+            }
+            case PixelFormat::YUYV: {
+                const uint8_t* src0 = job.src + static_cast<size_t>(row) * job.src_stride;
+                _kernels.yuyv(src0, src0 + job.src_stride, dst_y0, dst_y1, dst_u, dst_v, job.width);
+                break;
+            }
+            case PixelFormat::NV12: {
+                // Y 平面直接拷贝，UV 平面位于 Y 平面之后，步长与 Y 相同
+                const uint8_t* src_y0 = job.src + static_cast<size_t>(row) * job.src_stride;
+                const uint8_t* src_uv = job.src + static_cast<size_t>(job.height + pair) * job.src_stride;
+                memcpy(dst_y0, src_y0, job.width);
+                memcpy(dst_y1, src_y0 + job.src_stride, job.width);
+                _kernels.split_uv(src_uv, dst_u, dst_v, chroma_width);
+                break;
+            }
+            default:
+                return;
+        }
+    }
+}
@@ -0,0 +1,83 @@
+//
+// Created by pengx on 2026/10/16.
+//
+
+#ifndef GB28181CONSOLE_COLOR_CONVERTER_HPP
+#define GB28181CONSOLE_COLOR_CONVERTER_HPP
+
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "color_kernels.hpp"
+#include "logger.hpp"
+#include "video_frame.hpp"
+
+/**
+ * 采集帧 -> I420 颜色转换（同尺寸，不缩放）
+ *
+ * 一帧按偶数行切成若干行带，调用线程处理第一个行带，其余行带交给常驻工作线程并行处理，
+ * 每个行带内部使用 SIMD 内核（见 color_kernels.hpp）。
+ * */
+class ColorConverter {
+public:
+    /**
+     * @param thread_count 并行度（含调用线程），1 表示不创建工作线程
+     */
+    explicit ColorConverter(int thread_count);
+
+    ~ColorConverter();
+
+    ColorConverter(const ColorConverter&) = delete;
+
+    ColorConverter& operator=(const ColorConverter&) = delete;
+
+    /**
+     * 转换到 I420
+     *
+     * @param frame 采集帧（BGR24 / YUYV / NV12）
+     * @param dst 目标 Y/U/V 平面
+     * @param dst_stride 目标平面步长
+     * @return 不支持的格式或奇数尺寸返回 false，由调用方回退到 sws_scale
+     */
+    bool toI420(const VideoFrame& frame, uint8_t* const dst[3], const int dst_stride[3]);
+
+    const char* kernelName() const {
+        return _kernels.name;
+    }
+
+private:
+    /**
+     * 一帧的转换任务
+     */
+    struct Job {
+        PixelFormat format = PixelFormat::BGR24;
+        const uint8_t* src = nullptr;
+        int src_stride = 0;
+        uint8_t* dst[3] = {nullptr, nullptr, nullptr};
+        int dst_stride[3] = {0, 0, 0};
+        int width = 0;
+        int height = 0;
+        int band_count = 1;
+    };
+
+    Logger _logger;
+    const ColorKernels& _kernels;
+
+    std::vector<std::thread> _workers;
+    std::mutex _mutex;
+    std::condition_variable _start_cv;
+    std::condition_variable _done_cv;
+    Job _job;
+    uint64_t _generation = 0; // 每提交一帧加一，工作线程据此判断是否有新任务
+    int _pending = 0;         // 尚未完成的工作线程行带数
+    bool _is_running = true;
+
+    void worker_loop(int band);
+
+    void convert_band(const Job& job, int band) const;
+};
+
+#endif //GB28181CONSOLE_COLOR_CONVERTER_HPP
@@ -0,0 +1,461 @@
+//
+// Created by pengx on 2026/10/16.
+//
+
+#include "color_kernels.hpp"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define COLOR_KERNELS_X86 1
+#include <immintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define COLOR_KERNELS_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace {
+// ============================================================
+// 标量参考实现
+// ============================================================
+inline uint8_t rgb_to_y(const int r, const int g, const int b) {
+    return static_cast<uint8_t>((66 * r + 129 * g + 25 * b + 4224) >> 8);
+}
+
+inline uint8_t rgb_to_u(const int r, const int g, const int b) {
+    return static_cast<uint8_t>((112 * b - 38 * r - 74 * g + 32896) >> 8);
+}
+
+inline uint8_t rgb_to_v(const int r, const int g, const int b) {
+    return static_cast<uint8_t>((112 * r - 94 * g - 18 * b + 32896) >> 8);
+}
+
+void bgr24_scalar(const uint8_t* src0, const uint8_t* src1, uint8_t* dst_y0, uint8_t* dst_y1,
+                  uint8_t* dst_u, uint8_t* dst_v, const int width) {
+    for (int x = 0; x < width; x += 2) {
+        const uint8_t* p00 = src0 + x * 3;
+        const uint8_t* p01 = p00 + 3;
+        const uint8_t* p10 = src1 + x * 3;
+        const uint8_t* p11 = p10 + 3;
+
+        dst_y0[x] = rgb_to_y(p00[2], p00[1], p00[0]);
+        dst_y0[x + 1] = rgb_to_y(p01[2], p01[1], p01[0]);
+        dst_y1[x] = rgb_to_y(p10[2], p10[1], p10[0]);
+        dst_y1[x + 1] = rgb_to_y(p11[2], p11[1], p11[0]);
+
+        // 2x2 平均后再计算色度
+        const int b = (p00[0] + p01[0] + p10[0] + p11[0] + 2) >> 2;
+        const int g = (p00[1] + p01[1] + p10[1] + p11[1] + 2) >> 2;
+        const int r = (p00[2] + p01[2] + p10[2] + p11[2] + 2) >> 2;
+        dst_u[x / 2] = rgb_to_u(r, g, b);
+        dst_v[x / 2] = rgb_to_v(r, g, b);
+    }
+}
+
+void yuyv_scalar(const uint8_t* src0, const uint8_t* src1, uint8_t* dst_y0, uint8_t* dst_y1,
+                 uint8_t* dst_u, uint8_t* dst_v, const int width) {
+    for (int x = 0; x < width; x += 2) {
+        // Y0 U Y1 V
+        const uint8_t* s0 = src0 + x * 2;
+        const uint8_t* s1 = src1 + x * 2;
+        dst_y0[x] = s0[0];
+        dst_y0[x + 1] = s0[2];
+        dst_y1[x] = s1[0];
+        dst_y1[x + 1] = s1[2];
+        // 水平方向已是 4:2:2，只需垂直平均
+        dst_u[x / 2] = static_cast<uint8_t>((s0[1] + s1[1] + 1) >> 1);
+        dst_v[x / 2] = static_cast<uint8_t>((s0[3] + s1[3] + 1) >> 1);
+    }
+}
+
+void split_uv_scalar(const uint8_t* src_uv, uint8_t* dst_u, uint8_t* dst_v, const int chroma_width) {
+    for (int i = 0; i < chroma_width; ++i) {
+        dst_u[i] = src_uv[i * 2];
+        dst_v[i] = src_uv[i * 2 + 1];
+    }
+}
+
+const ColorKernels SCALAR_KERNELS = {"scalar", bgr24_scalar, yuyv_scalar, split_uv_scalar};
+
+#if defined(COLOR_KERNELS_X86)
+// ============================================================
+// x86: SSE2 / SSSE3 / AVX2（按函数指定目标指令集，运行时分派，无需全局编译选项）
+// ============================================================
+#define TARGET_SSE2 __attribute__((target("sse2")))
+#define TARGET_SSSE3 __attribute__((target("ssse3")))
+#define TARGET_AVX2 __attribute__((target("avx2")))
+
+// 16 位通道上的定点系数（32896 超出 short 范围，按位表示即可，运算本身是回绕的）
+#define K16(v) static_cast<short>(v)
+
+TARGET_SSE2 void yuyv_sse2(const uint8_t* src0, const uint8_t* src1, uint8_t* dst_y0, uint8_t* dst_y1,
+                           uint8_t* dst_u, uint8_t* dst_v, const int width) {
+    const __m128i mask = _mm_set1_epi16(0x00ff);
+    const __m128i zero = _mm_setzero_si128();
+    int x = 0;
+    for (; x + 16 <= width; x += 16) {
+        const __m128i a0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src0 + x * 2));
+        const __m128i b0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src0 + x * 2 + 16));
+        const __m128i a1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src1 + x * 2));
+        const __m128i b1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src1 + x * 2 + 16));
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst_y0 + x),
+                         _mm_packus_epi16(_mm_and_si128(a0, mask), _mm_and_si128(b0, mask)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst_y1 + x),
+                         _mm_packus_epi16(_mm_and_si128(a1, mask), _mm_and_si128(b1, mask)));
+
+        // U0 V0 U1 V1 ...，两行做 (a + b + 1) >> 1 平均
+        const __m128i c0 = _mm_packus_epi16(_mm_srli_epi16(a0, 8), _mm_srli_epi16(b0, 8));
+        const __m128i c1 = _mm_packus_epi16(_mm_srli_epi16(a1, 8), _mm_srli_epi16(b1, 8));
+        const __m128i c = _mm_avg_epu8(c0, c1);
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(dst_u + x / 2), _mm_packus_epi16(_mm_and_si128(c, mask), zero));
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(dst_v + x / 2), _mm_packus_epi16(_mm_srli_epi16(c, 8), zero));
+    }
+    if (x < width) {
+        yuyv_scalar(src0 + x * 2, src1 + x * 2, dst_y0 + x, dst_y1 + x, dst_u + x / 2, dst_v + x / 2, width - x);
+    }
+}
+
+TARGET_SSE2 void split_uv_sse2(const uint8_t* src_uv, uint8_t* dst_u, uint8_t* dst_v, const int chroma_width) {
+    const __m128i mask = _mm_set1_epi16(0x00ff);
+    int i = 0;
+    for (; i + 16 <= chroma_width; i += 16) {
+        const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src_uv + i * 2));
+        const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src_uv + i * 2 + 16));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst_u + i),
+                         _mm_packus_epi16(_mm_and_si128(a, mask), _mm_and_si128(b, mask)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst_v + i),
+                         _mm_packus_epi16(_mm_srli_epi16(a, 8), _mm_srli_epi16(b, 8)));
+    }
+    if (i < chroma_width) {
+        split_uv_scalar(src_uv + i * 2, dst_u + i, dst_v + i, chroma_width - i);
+    }
+}
+
+/**
+ * 16 个 BGR24 像素（48 字节）解交错为 B/G/R 三个 16 字节向量
+ */
+TARGET_SSSE3 inline void deinterleave_bgr16(const uint8_t* src, __m128i& b, __m128i& g, __m128i& r) {
+    const __m128i s0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+    const __m128i s1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 16));
+    const __m128i s2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 32));
+
+    b = _mm_or_si128(_mm_or_si128(
+                         _mm_shuffle_epi8(s0, _mm_setr_epi8(0, 3, 6, 9, 12, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1)),
+                         _mm_shuffle_epi8(s1, _mm_setr_epi8(-1, -1, -1, -1, -1, -1, 2, 5, 8, 11, 14, -1, -1, -1, -1, -1))),
+                     _mm_shuffle_epi8(s2, _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 1, 4, 7, 10, 13)));
+    g = _mm_or_si128(_mm_or_si128(
+                         _mm_shuffle_epi8(s0, _mm_setr_epi8(1, 4, 7, 10, 13, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1)),
+                         _mm_shuffle_epi8(s1, _mm_setr_epi8(-1, -1, -1, -1, -1, 0, 3, 6, 9, 12, 15, -1, -1, -1, -1, -1))),
+                     _mm_shuffle_epi8(s2, _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 2, 5, 8, 11, 14)));
+    r = _mm_or_si128(_mm_or_si128(
+                         _mm_shuffle_epi8(s0, _mm_setr_epi8(2, 5, 8, 11, 14, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1)),
+                         _mm_shuffle_epi8(s1, _mm_setr_epi8(-1, -1, -1, -1, -1, 1, 4, 7, 10, 13, -1, -1, -1, -1, -1, -1))),
+                     _mm_shuffle_epi8(s2, _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 0, 3, 6, 9, 12, 15)));
+}
+
+TARGET_SSE2 inline __m128i luma_sse2(const __m128i r, const __m128i g, const __m128i b) {
+    const __m128i y = _mm_add_epi16(_mm_add_epi16(_mm_mullo_epi16(r, _mm_set1_epi16(66)),
+                                                  _mm_mullo_epi16(g, _mm_set1_epi16(129))),
+                                    _mm_add_epi16(_mm_mullo_epi16(b, _mm_set1_epi16(25)),
+                                                  _mm_set1_epi16(4224)));
+    return _mm_srli_epi16(y, 8);
+}
+
+TARGET_SSE2 inline __m128i luma16_sse2(const __m128i r, const __m128i g, const __m128i b) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i lo = luma_sse2(_mm_unpacklo_epi8(r, zero), _mm_unpacklo_epi8(g, zero), _mm_unpacklo_epi8(b, zero));
+    const __m128i hi = luma_sse2(_mm_unpackhi_epi8(r, zero), _mm_unpackhi_epi8(g, zero), _mm_unpackhi_epi8(b, zero));
+    return _mm_packus_epi16(lo, hi);
+}
+
+/**
+ * 两行各 16 个像素的某一分量 -> 8 个 2x2 平均值（16 位通道）
+ */
+TARGET_SSSE3 inline __m128i average2x2_ssse3(const __m128i row0, const __m128i row1) {
+    const __m128i ones = _mm_set1_epi8(1);
+    const __m128i sum = _mm_add_epi16(_mm_maddubs_epi16(row0, ones), _mm_maddubs_epi16(row1, ones));
+    return _mm_srli_epi16(_mm_add_epi16(sum, _mm_set1_epi16(2)), 2);
+}
+
+TARGET_SSSE3 void bgr24_ssse3(const uint8_t* src0, const uint8_t* src1, uint8_t* dst_y0, uint8_t* dst_y1,
+                              uint8_t* dst_u, uint8_t* dst_v, const int width) {
+    int x = 0;
+    for (; x + 16 <= width; x += 16) {
+        __m128i b0, g0, r0, b1, g1, r1;
+        deinterleave_bgr16(src0 + x * 3, b0, g0, r0);
+        deinterleave_bgr16(src1 + x * 3, b1, g1, r1);
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst_y0 + x), luma16_sse2(r0, g0, b0));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst_y1 + x), luma16_sse2(r1, g1, b1));
+
+        const __m128i b = average2x2_ssse3(b0, b1);
+        const __m128i g = average2x2_ssse3(g0, g1);
+        const __m128i r = average2x2_ssse3(r0, r1);
+        const __m128i u = _mm_srli_epi16(_mm_sub_epi16(_mm_sub_epi16(
+                                                           _mm_add_epi16(_mm_mullo_epi16(b, _mm_set1_epi16(112)),
+                                                                         _mm_set1_epi16(K16(32896))),
+                                                           _mm_mullo_epi16(r, _mm_set1_epi16(38))),
+                                                       _mm_mullo_epi16(g, _mm_set1_epi16(74))), 8);
+        const __m128i v = _mm_srli_epi16(_mm_sub_epi16(_mm_sub_epi16(
+                                                           _mm_add_epi16(_mm_mullo_epi16(r, _mm_set1_epi16(112)),
+                                                                         _mm_set1_epi16(K16(32896))),
+                                                           _mm_mullo_epi16(g, _mm_set1_epi16(94))),
+                                                       _mm_mullo_epi16(b, _mm_set1_epi16(18))), 8);
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(dst_u + x / 2), _mm_packus_epi16(u, u));
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(dst_v + x / 2), _mm_packus_epi16(v, v));
+    }
+    if (x < width) {
+        bgr24_scalar(src0 + x * 3, src1 + x * 3, dst_y0 + x, dst_y1 + x, dst_u + x / 2, dst_v + x / 2, width - x);
+    }
+}
+
+TARGET_AVX2 inline __m256i combine_avx2(const __m128i lo, const __m128i hi) {
+    return _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1);
+}
+
+TARGET_AVX2 inline __m256i luma_avx2(const __m256i r, const __m256i g, const __m256i b) {
+    const __m256i y = _mm256_add_epi16(_mm256_add_epi16(_mm256_mullo_epi16(r, _mm256_set1_epi16(66)),
+                                                        _mm256_mullo_epi16(g, _mm256_set1_epi16(129))),
+                                       _mm256_add_epi16(_mm256_mullo_epi16(b, _mm256_set1_epi16(25)),
+                                                        _mm256_set1_epi16(4224)));
+    return _mm256_srli_epi16(y, 8);
+}
+
+/**
+ * 32 个像素的 Y（两组 16 像素的 B/G/R）
+ */
+TARGET_AVX2 inline __m256i luma32_avx2(const __m128i r_lo, const __m128i g_lo, const __m128i b_lo,
+                                       const __m128i r_hi, const __m128i g_hi, const __m128i b_hi) {
+    const __m256i y_lo = luma_avx2(_mm256_cvtepu8_epi16(r_lo), _mm256_cvtepu8_epi16(g_lo),
+                                   _mm256_cvtepu8_epi16(b_lo));
+    const __m256i y_hi = luma_avx2(_mm256_cvtepu8_epi16(r_hi), _mm256_cvtepu8_epi16(g_hi),
+                                   _mm256_cvtepu8_epi16(b_hi));
+    // packus 按 128 位通道交错，需要重新排列 64 位块
+    return _mm256_permute4x64_epi64(_mm256_packus_epi16(y_lo, y_hi), 0xD8);
+}
+
+TARGET_AVX2 inline __m256i average2x2_avx2(const __m256i row0, const __m256i row1) {
+    const __m256i ones = _mm256_set1_epi8(1);
+    const __m256i sum = _mm256_add_epi16(_mm256_maddubs_epi16(row0, ones), _mm256_maddubs_epi16(row1, ones));
+    return _mm256_srli_epi16(_mm256_add_epi16(sum, _mm256_set1_epi16(2)), 2);
+}
+
+/**
+ * 16 个 16 位通道 -> 16 字节（饱和），保持顺序
+ */
+TARGET_AVX2 inline __m128i pack16_avx2(const __m256i value) {
+    return _mm256_castsi256_si128(_mm256_permute4x64_epi64(_mm256_packus_epi16(value, value), 0xD8));
+}
+
+TARGET_AVX2 void bgr24_avx2(const uint8_t* src0, const uint8_t* src1, uint8_t* dst_y0, uint8_t* dst_y1,
+                            uint8_t* dst_u, uint8_t* dst_v, const int width) {
+    int x = 0;
+    for (; x + 32 <= width; x += 32) {
+        __m128i b0l, g0l, r0l, b0h, g0h, r0h, b1l, g1l, r1l, b1h, g1h, r1h;
+        deinterleave_bgr16(src0 + x * 3, b0l, g0l, r0l);
+        deinterleave_bgr16(src0 + x * 3 + 48, b0h, g0h, r0h);
+        deinterleave_bgr16(src1 + x * 3, b1l, g1l, r1l);
+        deinterleave_bgr16(src1 + x * 3 + 48, b1h, g1h, r1h);
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst_y0 + x), luma32_avx2(r0l, g0l, b0l, r0h, g0h, b0h));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst_y1 + x), luma32_avx2(r1l, g1l, b1l, r1h, g1h, b1h));
+
+        const __m256i b = average2x2_avx2(combine_avx2(b0l, b0h), combine_avx2(b1l, b1h));
+        const __m256i g = average2x2_avx2(combine_avx2(g0l, g0h), combine_avx2(g1l, g1h));
+        const __m256i r = average2x2_avx2(combine_avx2(r0l, r0h), combine_avx2(r1l, r1h));
+        const __m256i u = _mm256_srli_epi16(_mm256_sub_epi16(_mm256_sub_epi16(
+                                                                 _mm256_add_epi16(
+                                                                     _mm256_mullo_epi16(b, _mm256_set1_epi16(112)),
+                                                                     _mm256_set1_epi16(K16(32896))),
+                                                                 _mm256_mullo_epi16(r, _mm256_set1_epi16(38))),
+                                                             _mm256_mullo_epi16(g, _mm256_set1_epi16(74))), 8);
+        const __m256i v = _mm256_srli_epi16(_mm256_sub_epi16(_mm256_sub_epi16(
+                                                                 _mm256_add_epi16(
+                                                                     _mm256_mullo_epi16(r, _mm256_set1_epi16(112)),
+                                                                     _mm256_set1_epi16(K16(32896))),
+                                                                 _mm256_mullo_epi16(g, _mm256_set1_epi16(94))),
+                                                             _mm256_mullo_epi16(b, _mm256_set1_epi16(18))), 8);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst_u + x / 2), pack16_avx2(u));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst_v + x / 2), pack16_avx2(v));
+    }
+    if (x < width) {
+        bgr24_ssse3(src0 + x * 3, src1 + x * 3, dst_y0 + x, dst_y1 + x, dst_u + x / 2, dst_v + x / 2, width - x);
+    }
+}
+
+TARGET_AVX2 void yuyv_avx2(const uint8_t* src0, const uint8_t* src1, uint8_t* dst_y0, uint8_t* dst_y1,
+                           uint8_t* dst_u, uint8_t* dst_v, const int width) {
+    const __m256i mask = _mm256_set1_epi16(0x00ff);
+    int x = 0;
+    for (; x + 32 <= width; x += 32) {
+        const __m256i a0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src0 + x * 2));
+        const __m256i b0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src0 + x * 2 + 32));
+        const __m256i a1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src1 + x * 2));
+        const __m256i b1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src1 + x * 2 + 32));
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst_y0 + x), _mm256_permute4x64_epi64(
+                                _mm256_packus_epi16(_mm256_and_si256(a0, mask), _mm256_and_si256(b0, mask)), 0xD8));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst_y1 + x), _mm256_permute4x64_epi64(
+                                _mm256_packus_epi16(_mm256_and_si256(a1, mask), _mm256_and_si256(b1, mask)), 0xD8));
+
+        const __m256i c0 = _mm256_permute4x64_epi64(
+            _mm256_packus_epi16(_mm256_srli_epi16(a0, 8), _mm256_srli_epi16(b0, 8)), 0xD8);
+        const __m256i c1 = _mm256_permute4x64_epi64(
+            _mm256_packus_epi16(_mm256_srli_epi16(a1, 8), _mm256_srli_epi16(b1, 8)), 0xD8);
+        const __m256i c = _mm256_avg_epu8(c0, c1);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst_u + x / 2), pack16_avx2(_mm256_and_si256(c, mask)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst_v + x / 2), pack16_avx2(_mm256_srli_epi16(c, 8)));
+    }
+    if (x < width) {
+        yuyv_sse2(src0 + x * 2, src1 + x * 2, dst_y0 + x, dst_y1 + x, dst_u + x / 2, dst_v + x / 2, width - x);
+    }
+}
+
+TARGET_AVX2 void split_uv_avx2(const uint8_t* src_uv, uint8_t* dst_u, uint8_t* dst_v, const int chroma_width) {
+    const __m256i mask = _mm256_set1_epi16(0x00ff);
+    int i = 0;
+    for (; i + 32 <= chroma_width; i += 32) {
+        const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src_uv + i * 2));
+        const __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src_uv + i * 2 + 32));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst_u + i), _mm256_permute4x64_epi64(
+                                _mm256_packus_epi16(_mm256_and_si256(a, mask), _mm256_and_si256(b, mask)), 0xD8));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst_v + i), _mm256_permute4x64_epi64(
+                                _mm256_packus_epi16(_mm256_srli_epi16(a, 8), _mm256_srli_epi16(b, 8)), 0xD8));
+    }
+    if (i < chroma_width) {
+        split_uv_sse2(src_uv + i * 2, dst_u + i, dst_v + i, chroma_width - i);
+    }
+}
+
+const ColorKernels SSE2_KERNELS = {"SSE2", bgr24_scalar, yuyv_sse2, split_uv_sse2};
+const ColorKernels SSSE3_KERNELS = {"SSSE3", bgr24_ssse3, yuyv_sse2, split_uv_sse2};
+const ColorKernels AVX2_KERNELS = {"AVX2", bgr24_avx2, yuyv_avx2, split_uv_avx2};
+
+#elif defined(COLOR_KERNELS_NEON)
+// ============================================================
+// ARM: NEON（AArch64 必备，ARMv7 需编译时开启 -mfpu=neon）
+// ============================================================
+inline uint8x8_t luma_neon(const uint8x8_t r, const uint8x8_t g, const uint8x8_t b) {
+    uint16x8_t y = vmull_u8(r, vdup_n_u8(66));
+    y = vmlal_u8(y, g, vdup_n_u8(129));
+    y = vmlal_u8(y, b, vdup_n_u8(25));
+    y = vaddq_u16(y, vdupq_n_u16(4224));
+    return vshrn_n_u16(y, 8);
+}
+
+inline uint8x16_t luma16_neon(const uint8x16x3_t& bgr) {
+    return vcombine_u8(luma_neon(vget_low_u8(bgr.val[2]), vget_low_u8(bgr.val[1]), vget_low_u8(bgr.val[0])),
+                       luma_neon(vget_high_u8(bgr.val[2]), vget_high_u8(bgr.val[1]), vget_high_u8(bgr.val[0])));
+}
+
+inline uint16x8_t average2x2_neon(const uint8x16_t row0, const uint8x16_t row1) {
+    const uint16x8_t sum = vaddq_u16(vpaddlq_u8(row0), vpaddlq_u8(row1));
+    return vshrq_n_u16(vaddq_u16(sum, vdupq_n_u16(2)), 2);
+}
+
+void bgr24_neon(const uint8_t* src0, const uint8_t* src1, uint8_t* dst_y0, uint8_t* dst_y1,
+                uint8_t* dst_u, uint8_t* dst_v, const int width) {
+    int x = 0;
+    for (; x + 16 <= width; x += 16) {
+        const uint8x16x3_t p0 = vld3q_u8(src0 + x * 3);
+        const uint8x16x3_t p1 = vld3q_u8(src1 + x * 3);
+        vst1q_u8(dst_y0 + x, luma16_neon(p0));
+        vst1q_u8(dst_y1 + x, luma16_neon(p1));
+
+        const uint16x8_t b = average2x2_neon(p0.val[0], p1.val[0]);
+        const uint16x8_t g = average2x2_neon(p0.val[1], p1.val[1]);
+        const uint16x8_t r = average2x2_neon(p0.val[2], p1.val[2]);
+        uint16x8_t u = vmlaq_n_u16(vdupq_n_u16(32896), b, 112);
+        u = vmlsq_n_u16(u, r, 38);
+        u = vmlsq_n_u16(u, g, 74);
+        uint16x8_t v = vmlaq_n_u16(vdupq_n_u16(32896), r, 112);
+        v = vmlsq_n_u16(v, g, 94);
+        v = vmlsq_n_u16(v, b, 18);
+        vst1_u8(dst_u + x / 2, vshrn_n_u16(u, 8));
+        vst1_u8(dst_v + x / 2, vshrn_n_u16(v, 8));
+    }
+    if (x < width) {
+        bgr24_scalar(src0 + x * 3, src1 + x * 3, dst_y0 + x, dst_y1 + x, dst_u + x / 2, dst_v + x / 2, width - x);
+    }
+}
+
+void yuyv_neon(const uint8_t* src0, const uint8_t* src1, uint8_t* dst_y0, uint8_t* dst_y1,
+               uint8_t* dst_u, uint8_t* dst_v, const int width) {
+    int x = 0;
+    for (; x + 16 <= width; x += 16) {
+        // val[0] = Y，val[1] = U0 V0 U1 V1 ...
+        const uint8x16x2_t s0 = vld2q_u8(src0 + x * 2);
+        const uint8x16x2_t s1 = vld2q_u8(src1 + x * 2);
+        vst1q_u8(dst_y0 + x, s0.val[0]);
+        vst1q_u8(dst_y1 + x, s1.val[0]);
+
+        const uint8x16_t c = vrhaddq_u8(s0.val[1], s1.val[1]);
+        const uint8x8x2_t uv = vuzp_u8(vget_low_u8(c), vget_high_u8(c));
+        vst1_u8(dst_u + x / 2, uv.val[0]);
+        vst1_u8(dst_v + x / 2, uv.val[1]);
+    }
+    if (x < width) {
+        yuyv_scalar(src0 + x * 2, src1 + x * 2, dst_y0 + x, dst_y1 + x, dst_u + x / 2, dst_v + x / 2, width - x);
+    }
+}
+
+void split_uv_neon(const uint8_t* src_uv, uint8_t* dst_u, uint8_t* dst_v, const int chroma_width) {
+    int i = 0;
+    for (; i + 16 <= chroma_width; i += 16) {
+        const uint8x16x2_t uv = vld2q_u8(src_uv + i * 2);
+        vst1q_u8(dst_u + i, uv.val[0]);
+        vst1q_u8(dst_v + i, uv.val[1]);
+    }
+    if (i < chroma_width) {
+        split_uv_scalar(src_uv + i * 2, dst_u + i, dst_v + i, chroma_width - i);
+    }
+}
+
+const ColorKernels NEON_KERNELS = {"NEON", bgr24_neon, yuyv_neon, split_uv_neon};
+#endif
+
+const ColorKernels& select_kernels() {
+#if defined(COLOR_KERNELS_X86)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return AVX2_KERNELS;
+    }
+    if (__builtin_cpu_supports("ssse3")) {
+        return SSSE3_KERNELS;
+    }
+    if (__builtin_cpu_supports("sse2")) {
+        return SSE2_KERNELS;
+    }
+#elif defined(COLOR_KERNELS_NEON)
+    return NEON_KERNELS;
+#endif
+    return SCALAR_KERNELS;
+}
+} // namespace
+
+const ColorKernels& scalarColorKernels() {
+    return SCALAR_KERNELS;
+}
+
+const ColorKernels& bestColorKernels() {
+    static const ColorKernels& kernels = select_kernels();
+    return kernels;
+}
+
+std::vector<const ColorKernels*> supportedColorKernels() {
+    std::vector<const ColorKernels*> kernels{&SCALAR_KERNELS};
+#if defined(COLOR_KERNELS_X86)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("sse2")) {
+        kernels.push_back(&SSE2_KERNELS);
+    }
+    if (__builtin_cpu_supports("ssse3")) {
+        kernels.push_back(&SSSE3_KERNELS);
+    }
+    if (__builtin_cpu_supports("avx2")) {
+        kernels.push_back(&AVX2_KERNELS);
+    }
+#elif defined(COLOR_KERNELS_NEON)
+    kernels.push_back(&NEON_KERNELS);
+#endif
+    return kernels;
+}
@@ -0,0 +1,61 @@
+//
+// Created by pengx on 2026/10/16.
+//
+
+#ifndef GB28181CONSOLE_COLOR_KERNELS_HPP
+#define GB28181CONSOLE_COLOR_KERNELS_HPP
+
+#include <cstdint>
+#include <vector>
+
+/**
+ * 颜色转换内核（目标格式 I420 / YUV420P，BT.601 有限范围，定点整数运算）
+ *
+ * 每个内核处理一对亮度行（对应一行色度），SIMD 版本处理不足一个向量宽度的行尾时回退到标量版本，
+ * 因此所有实现与标量参考实现逐字节一致。
+ *
+ * 定点公式（全部结果落在 [0, 65535]，16 位无符号回绕运算即可精确计算）：
+ * - Y = (66R + 129G + 25B + 4224) >> 8           （4224 = 128 + (16 << 8)）
+ * - U = (112B - 38R - 74G + 32896) >> 8          （32896 = 128 + (128 << 8)）
+ * - V = (112R - 94G - 18B + 32896) >> 8
+ * - 色度取 2x2 像素平均：(s00 + s01 + s10 + s11 + 2) >> 2
+ * */
+
+/**
+ * BGR24 / YUYV 两行 -> 两行 Y + 一行 U + 一行 V
+ *
+ * @param width 像素宽度，必须为偶数
+ */
+using RowPairKernel = void (*)(const uint8_t* src0, const uint8_t* src1, uint8_t* dst_y0, uint8_t* dst_y1,
+                               uint8_t* dst_u, uint8_t* dst_v, int width);
+
+/**
+ * NV12 交错 UV 行 -> U 行 + V 行
+ *
+ * @param chroma_width 色度宽度（像素宽度 / 2）
+ */
+using SplitUvKernel = void (*)(const uint8_t* src_uv, uint8_t* dst_u, uint8_t* dst_v, int chroma_width);
+
+struct ColorKernels {
+    const char* name;
+    RowPairKernel bgr24;
+    RowPairKernel yuyv;
+    SplitUvKernel split_uv;
+};
+
+/**
+ * 标量参考实现，SIMD 版本以它为准
+ */
+const ColorKernels& scalarColorKernels();
+
+/**
+ * 按运行时 CPU 特性选择的最优实现（x86: AVX2 > SSSE3/SSE2，ARM: NEON），首次调用时确定
+ */
+const ColorKernels& bestColorKernels();
+
+/**
+ * 当前 CPU 支持的全部实现，标量参考实现排在首位（供一致性校验与基准对比）
+ */
+std::vector<const ColorKernels*> supportedColorKernels();
+
+#endif //GB28181CONSOLE_COLOR_KERNELS_HPP
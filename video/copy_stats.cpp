@@ -0,0 +1,65 @@
+//
+// Created by pengx on 2026/10/16.
+//
+
+#include "copy_stats.hpp"
+
+double CopyStats::Snapshot::copiesPerFrame() const {
+    if (frames == 0) {
+        return 0;
+    }
+    uint64_t total = 0;
+    for (const uint64_t count : copies) {
+        total += count;
+    }
+    return static_cast<double>(total) / static_cast<double>(frames);
+}
+
+double CopyStats::Snapshot::copiesPerByte() const {
+    if (frame_bytes == 0) {
+        return 0;
+    }
+    uint64_t total = 0;
+    for (const uint64_t count : bytes) {
+        total += count;
+    }
+    return static_cast<double>(total) / static_cast<double>(frame_bytes);
+}
+
+void CopyStats::onFrame(const size_t bytes) {
+    _frames.fetch_add(1, std::memory_order_relaxed);
+    _frame_bytes.fetch_add(bytes, std::memory_order_relaxed);
+}
+
+void CopyStats::onCopy(const CopyStage stage, const size_t bytes) {
+    const int index = static_cast<int>(stage);
+    _copies[index].fetch_add(1, std::memory_order_relaxed);
+    _bytes[index].fetch_add(bytes, std::memory_order_relaxed);
+}
+
+void CopyStats::onGather(const size_t bytes) {
+    _gather_bytes.fetch_add(bytes, std::memory_order_relaxed);
+}
+
+CopyStats::Snapshot CopyStats::snapshot() const {
+    Snapshot snapshot;
+    snapshot.frames = _frames.load(std::memory_order_relaxed);
+    snapshot.frame_bytes = _frame_bytes.load(std::memory_order_relaxed);
+    snapshot.gather_bytes = _gather_bytes.load(std::memory_order_relaxed);
+    for (int i = 0; i < static_cast<int>(CopyStage::COUNT); ++i) {
+        snapshot.copies[i] = _copies[i].load(std::memory_order_relaxed);
+        snapshot.bytes[i] = _bytes[i].load(std::memory_order_relaxed);
+    }
+    return snapshot;
+}
+
+const char* CopyStats::stageName(const CopyStage stage) {
+    switch (stage) {
+        case CopyStage::ENCODER_OUTPUT:
+            return "encoder output";
+        case CopyStage::PES_PAYLOAD:
+            return "PES payload";
+        default:
+            return "unknown";
+    }
+}
@@ -0,0 +1,71 @@
+//
+// Created by pengx on 2026/10/16.
+//
+
+#ifndef GB28181CONSOLE_COPY_STATS_HPP
+#define GB28181CONSOLE_COPY_STATS_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * 编码输出之后码流数据被拷贝的位置
+ */
+enum class CopyStage {
+    ENCODER_OUTPUT = 0, // 编码器输出包 -> 下游缓冲区
+    PES_PAYLOAD,        // NALU 重新拼装为 PES 负载
+    COUNT
+};
+
+/**
+ * 码流拷贝统计（全局）
+ *
+ * 每帧编码输出调用 onFrame()，每次整段拷贝码流数据调用 onCopy()，
+ * 由此得到「每帧拷贝次数」和「每字节被拷贝次数」，用于验证零拷贝优化的效果。
+ * PS/RTP 头部与负载以 iovec 按引用交给内核，发送时调用 onGather() 记录字节数，不计入拷贝。
+ * */
+class CopyStats {
+public:
+    struct Snapshot {
+        uint64_t frames = 0;                                      // 编码输出帧数
+        uint64_t frame_bytes = 0;                                 // 编码输出字节数
+        uint64_t copies[static_cast<int>(CopyStage::COUNT)]{};    // 各阶段拷贝次数
+        uint64_t bytes[static_cast<int>(CopyStage::COUNT)]{};     // 各阶段拷贝字节数
+        uint64_t gather_bytes = 0;                                // 按引用（iovec）交给内核的字节数
+
+        double copiesPerFrame() const;
+
+        double copiesPerByte() const;
+    };
+
+    static CopyStats* get() {
+        static CopyStats instance;
+        return &instance;
+    }
+
+    CopyStats(const CopyStats&) = delete;
+
+    CopyStats& operator=(const CopyStats&) = delete;
+
+    void onFrame(size_t bytes);
+
+    void onCopy(CopyStage stage, size_t bytes);
+
+    void onGather(size_t bytes);
+
+    Snapshot snapshot() const;
+
+    static const char* stageName(CopyStage stage);
+
+private:
+    CopyStats() = default;
+
+    std::atomic<uint64_t> _frames{0};
+    std::atomic<uint64_t> _frame_bytes{0};
+    std::atomic<uint64_t> _copies[static_cast<int>(CopyStage::COUNT)]{};
+    std::atomic<uint64_t> _bytes[static_cast<int>(CopyStage::COUNT)]{};
+    std::atomic<uint64_t> _gather_bytes{0};
+};
+
+#endif //GB28181CONSOLE_COPY_STATS_HPP
@@ -0,0 +1,109 @@
+//
+// Created by pengx on 2026/10/16.
+//
+
+#include "encode_governor.hpp"
+
+#include <algorithm>
+
+namespace {
+// 降级阶梯：先降帧率（每帧预算变长），仍不够再降分辨率（单帧工作量约减为 1/4）
+// 编码器已是 ultrafast 预设，没有更快的预设可降
+constexpr EncodeGovernor::Level LEVELS[] = {
+    {"full", 1, 1, 1},
+    {"fps 2/3", 2, 3, 1},
+    {"fps 1/2", 1, 2, 1},
+    {"fps 1/2, size 1/2", 1, 2, 2},
+};
+constexpr int LEVEL_COUNT = static_cast<int>(sizeof(LEVELS) / sizeof(LEVELS[0]));
+
+// 负载超过该值视为超预算（留一点余量给调度抖动）
+constexpr double OVERLOAD_THRESHOLD = 0.9;
+// 升一级后的预估负载低于该值才升级
+constexpr double HEADROOM_THRESHOLD = 0.7;
+// 连续超预算多少个窗口降级
+constexpr int OVERLOAD_WINDOWS = 2;
+// 连续有余量多少个窗口升级（比降级慢，避免来回振荡）
+constexpr int HEADROOM_WINDOWS = 5;
+} // namespace
+
+EncodeGovernor::EncodeGovernor(const VideoProfile& profile) : _logger("EncodeGovernor"), _profile(profile) {
+    _logger.iFmt("EncodeGovernor created, profile: %s, levels: %d", _profile.name.c_str(), LEVEL_COUNT);
+}
+
+const EncodeGovernor::Level& EncodeGovernor::level() const {
+    return LEVELS[_level.load(std::memory_order_relaxed)];
+}
+
+int EncodeGovernor::width() const {
+    return (_profile.width / level().scale_den) & ~1;
+}
+
+int EncodeGovernor::height() const {
+    return (_profile.height / level().scale_den) & ~1;
+}
+
+double EncodeGovernor::level_fps(const int level) const {
+    return static_cast<double>(_profile.fps) * LEVELS[level].fps_num / LEVELS[level].fps_den;
+}
+
+double EncodeGovernor::level_pixels(const int level) const {
+    return 1.0 / (LEVELS[level].scale_den * LEVELS[level].scale_den);
+}
+
+bool EncodeGovernor::update(const Sample& sample) {
+    if (sample.convert_frames == 0 || sample.encode_frames == 0 || _profile.fps <= 0) {
+        return false;
+    }
+
+    // 两级流水线的吞吐由较慢的阶段决定
+    const double convert_us = static_cast<double>(sample.convert_us) / sample.convert_frames;
+    const double encode_us = static_cast<double>(sample.encode_us) / sample.encode_frames;
+    const int current = _level.load(std::memory_order_relaxed);
+    const double budget_us = 1000000.0 / level_fps(current);
+    const double load = std::max(convert_us, encode_us) / budget_us;
+    _load.store(load, std::memory_order_relaxed);
+
+    if (load > OVERLOAD_THRESHOLD) {
+        _headroom_windows = 0;
+        if (++_over_windows >= OVERLOAD_WINDOWS && current + 1 < LEVEL_COUNT) {
+            change_level(current + 1, load);
+            return true;
+        }
+        return false;
+    }
+    _over_windows = 0;
+
+    if (current == 0) {
+        return false;
+    }
+    // 预估升一级后的负载：帧率升高缩短预算，分辨率升高按像素数增加工作量
+    const int upper = current - 1;
+    const double upper_load = load * (level_fps(upper) / level_fps(current)) *
+                              (level_pixels(upper) / level_pixels(current));
+    if (upper_load < HEADROOM_THRESHOLD) {
+        if (++_headroom_windows >= HEADROOM_WINDOWS) {
+            change_level(upper, load);
+            return true;
+        }
+    } else {
+        _headroom_windows = 0;
+    }
+    return false;
+}
+
+void EncodeGovernor::change_level(const int level, const double load) {
+    const int current = _level.load(std::memory_order_relaxed);
+    if (level > current) {
+        _step_downs.fetch_add(1, std::memory_order_relaxed);
+        _logger.wFmt("%s overloaded (load %.2f), step down: %s -> %s", _profile.name.c_str(), load,
+                     LEVELS[current].name, LEVELS[level].name);
+    } else {
+        _step_ups.fetch_add(1, std::memory_order_relaxed);
+        _logger.iFmt("%s has headroom (load %.2f), step up: %s -> %s", _profile.name.c_str(), load,
+                     LEVELS[current].name, LEVELS[level].name);
+    }
+    _level.store(level, std::memory_order_relaxed);
+    _over_windows = 0;
+    _headroom_windows = 0;
+}
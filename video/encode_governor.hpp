@@ -0,0 +1,102 @@
+//
+// Created by pengx on 2026/10/16.
+//
+
+#ifndef GB28181CONSOLE_ENCODE_GOVERNOR_HPP
+#define GB28181CONSOLE_ENCODE_GOVERNOR_HPP
+
+#include <atomic>
+#include <cstdint>
+
+#include "logger.hpp"
+#include "video_profile.hpp"
+
+/**
+ * 编码负载调节器
+ *
+ * 按统计窗口比较流水线单帧耗时（转换、编码两个阶段取较慢者）与帧间隔预算，
+ * 持续超预算时沿固定阶梯降级（降帧率 -> 降分辨率），余量恢复后再逐级升回，
+ * 保证输出实时，而不是在队列里悄悄丢帧、积累延迟。
+ *
+ * update() 只由编码线程调用；level() / width() / height() 可在转换线程读取。
+ * */
+class EncodeGovernor {
+public:
+    /**
+     * 降级阶梯中的一级
+     */
+    struct Level {
+        const char* name; // 日志名称
+        int fps_num;      // 保留帧比例 fps_num / fps_den
+        int fps_den;
+        int scale_den;    // 分辨率缩小倍数（宽高各除以该值）
+    };
+
+    /**
+     * 一个统计窗口内的流水线耗时
+     */
+    struct Sample {
+        uint64_t convert_frames = 0;
+        uint64_t convert_us = 0;
+        uint64_t encode_frames = 0;
+        uint64_t encode_us = 0;
+    };
+
+    explicit EncodeGovernor(const VideoProfile& profile);
+
+    /**
+     * 输入一个窗口的统计，必要时切换级别
+     *
+     * @return 级别发生变化返回 true
+     */
+    bool update(const Sample& sample);
+
+    const Level& level() const;
+
+    int levelIndex() const {
+        return _level.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * 当前级别的编码宽高（偶数）
+     */
+    int width() const;
+
+    int height() const;
+
+    uint64_t stepDowns() const {
+        return _step_downs.load(std::memory_order_relaxed);
+    }
+
+    uint64_t stepUps() const {
+        return _step_ups.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * 最近一个窗口的负载（较慢阶段耗时 / 帧间隔预算）
+     */
+    double load() const {
+        return _load.load(std::memory_order_relaxed);
+    }
+
+private:
+    Logger _logger;
+    const VideoProfile _profile;
+
+    std::atomic<int> _level{0};
+    std::atomic<uint64_t> _step_downs{0};
+    std::atomic<uint64_t> _step_ups{0};
+    std::atomic<double> _load{0};
+
+    // 连续超预算 / 连续有余量的窗口数（迟滞）
+    int _over_windows = 0;
+    int _headroom_windows = 0;
+
+    double level_fps(int level) const;
+
+    double level_pixels(int level) const;
+
+    void change_level(int level, double load);
+};
+
+#endif //GB28181CONSOLE_ENCODE_GOVERNOR_HPP
@@ -0,0 +1,35 @@
+//
+// Created by pengx on 2026/10/16.
+//
+
+#include "encoded_packet.hpp"
+
+std::shared_ptr<const EncodedPacket> EncodedPacket::takeFrom(AVPacket* packet, const VideoCodec codec, bool& is_copied) {
+    is_copied = false;
+    if (!packet || packet->size <= 0) {
+        return nullptr;
+    }
+
+    // 个别编码器输出的不是引用计数缓冲区，只能拷贝一次
+    if (!packet->buf) {
+        if (av_packet_make_refcounted(packet) < 0) {
+            return nullptr;
+        }
+        is_copied = true;
+    }
+
+    std::shared_ptr<EncodedPacket> encoded(new EncodedPacket());
+    encoded->_packet_ptr = av_packet_alloc();
+    if (!encoded->_packet_ptr) {
+        return nullptr;
+    }
+    av_packet_move_ref(encoded->_packet_ptr, packet);
+    encoded->_codec = codec;
+    return encoded;
+}
+
+EncodedPacket::~EncodedPacket() {
+    if (_packet_ptr) {
+        av_packet_free(&_packet_ptr);
+    }
+}
@@ -0,0 +1,75 @@
+//
+// Created by pengx on 2026/10/16.
+//
+
+#ifndef GB28181CONSOLE_ENCODED_PACKET_HPP
+#define GB28181CONSOLE_ENCODED_PACKET_HPP
+
+#include <cstdint>
+#include <memory>
+
+#include "video_codec.hpp"
+
+extern "C" {
+#include <libavcodec/avcodec.h>
+}
+
+/**
+ * 编码输出包（只读、引用计数）
+ *
+ * 接管编码器输出 AVPacket 的引用（av_packet_move_ref），码流数据本身不拷贝；
+ * 下游（PS 封装、GOP 缓存等）持有 EncodedPacketPtr 即可延长其生命周期，最后一个引用释放时归还给 FFmpeg。
+ * */
+class EncodedPacket {
+public:
+    /**
+     * 从编码器输出包创建，调用后 packet 被重置为空包，可继续用于 avcodec_receive_packet
+     *
+     * @param packet 编码器输出包
+     * @param codec 码流的编码格式
+     * @param is_copied 输出参数，数据不是引用计数缓冲区而必须拷贝时置为 true
+     */
+    static std::shared_ptr<const EncodedPacket> takeFrom(AVPacket* packet, VideoCodec codec, bool& is_copied);
+
+    ~EncodedPacket();
+
+    EncodedPacket(const EncodedPacket&) = delete;
+
+    EncodedPacket& operator=(const EncodedPacket&) = delete;
+
+    VideoCodec codec() const {
+        return _codec;
+    }
+
+    /**
+     * 完整的一帧码流（带起始码）
+     */
+    const uint8_t* data() const {
+        return _packet_ptr->data;
+    }
+
+    size_t size() const {
+        return static_cast<size_t>(_packet_ptr->size);
+    }
+
+    /**
+     * 采集时间戳（微秒，单调时钟），即编码器的 pts
+     */
+    int64_t captureUs() const {
+        return _packet_ptr->pts;
+    }
+
+    bool isKeyFrame() const {
+        return (_packet_ptr->flags & AV_PKT_FLAG_KEY) != 0;
+    }
+
+private:
+    EncodedPacket() = default;
+
+    AVPacket* _packet_ptr = nullptr;
+    VideoCodec _codec = VideoCodec::H264;
+};
+
+using EncodedPacketPtr = std::shared_ptr<const EncodedPacket>;
+
+#endif //GB28181CONSOLE_ENCODED_PACKET_HPP
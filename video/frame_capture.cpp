@@ -3,12 +3,17 @@
 //
 
 #include "frame_capture.hpp"
-#include "base_config.hpp"
 
 #include <chrono>
+#include <string>
+#include <thread>
+#include <linux/videodev2.h>
 
-FrameCapture::FrameCapture(const int index) : _logger("FrameCapture") {
+FrameCapture::FrameCapture(const int index, const uint32_t queue_depth, const size_t pool_size)
+    : _logger("FrameCapture") {
     _index = index;
+    _queue_depth = queue_depth;
+    _pool_size = pool_size;
     _logger.i("FrameCapture created");
 }
 
@@ -17,7 +22,64 @@ void FrameCapture::setCameraCallback(const CameraFrameCallback& frame_callback)
 }
 
 bool FrameCapture::start() {
-    if (!_cap.open(0, cv::CAP_V4L2)) {
+    // 缓冲池可能引用上一次打开的驱动缓冲区，先于设备释放
+    _pool_ptr.reset();
+    _device_ptr.reset();
+    if (open_v4l2()) {
+        _is_running = true;
+        _thread_ptr = std::make_unique<std::thread>(&FrameCapture::v4l2_capture_loop, this);
+        return true;
+    }
+
+    _logger.w("V4L2 mmap capture unavailable, falling back to cv::VideoCapture");
+    if (!open_video_capture()) {
+        return false;
+    }
+    _is_running = true;
+    _thread_ptr = std::make_unique<std::thread>(&FrameCapture::capture_loop, this);
+    return true;
+}
+
+bool FrameCapture::open_v4l2() {
+    // 编码器最终需要 YUV420P：I420 可直接拷贝，NV12 只需解交错色度，YUYV 需要色度下采样
+    static const struct {
+        uint32_t fourcc;
+        PixelFormat format;
+    } candidates[] = {
+        {V4L2_PIX_FMT_YUV420, PixelFormat::I420},
+        {V4L2_PIX_FMT_NV12, PixelFormat::NV12},
+        {V4L2_PIX_FMT_YUYV, PixelFormat::YUYV},
+    };
+
+    _device_ptr = std::make_unique<V4l2Device>("/dev/video" + std::to_string(_index));
+    for (const auto& candidate : candidates) {
+        if (!_device_ptr->open(VIDEO_WIDTH, VIDEO_HEIGHT, VIDEO_FPS, candidate.fourcc, _queue_depth)) {
+            continue;
+        }
+        if (!_device_ptr->startStreaming()) {
+            _device_ptr->close();
+            continue;
+        }
+        _pixel_format = candidate.format;
+
+        // 驱动的 mmap 缓冲区直接作为帧缓冲池，最后一个引用释放时归还给驱动，像素不拷贝
+        std::vector<FramePool::ExternalBuffer> buffers(_device_ptr->bufferCount());
+        for (uint32_t i = 0; i < buffers.size(); ++i) {
+            buffers[i].data = _device_ptr->bufferData(i);
+            buffers[i].size = _device_ptr->bufferLength(i);
+        }
+        V4l2Device* device = _device_ptr.get();
+        _pool_ptr = std::make_unique<FramePool>(buffers, [device](const uint32_t index) {
+            device->enqueue(index);
+        });
+        return true;
+    }
+    _device_ptr.reset();
+    return false;
+}
+
+bool FrameCapture::open_video_capture() {
+    if (!_cap.open(_index, cv::CAP_V4L2)) {
         return false;
     }
     // 设置参数
@@ -25,30 +87,107 @@ bool FrameCapture::start() {
     _cap.set(cv::CAP_PROP_FRAME_HEIGHT, VIDEO_HEIGHT);
     _cap.set(cv::CAP_PROP_FPS, VIDEO_FPS);
 
-    _is_running = true;
-    _thread_ptr = std::make_unique<std::thread>(&FrameCapture::capture_loop, this);
+    // 按实际分辨率预分配 BGR 缓冲池，read() 直接写入池内存
+    const int width = static_cast<int>(_cap.get(cv::CAP_PROP_FRAME_WIDTH));
+    const int height = static_cast<int>(_cap.get(cv::CAP_PROP_FRAME_HEIGHT));
+    _pool_ptr = std::make_unique<FramePool>(_pool_size, static_cast<size_t>(width) * height * 3);
     return true;
 }
 
+void FrameCapture::v4l2_capture_loop() {
+    const int width = _device_ptr->width();
+    const int height = _device_ptr->height();
+    const size_t stride = _device_ptr->bytesPerLine();
+
+    const auto retry_delay = std::chrono::milliseconds(static_cast<int64_t>(RETRY_DELAY_MS));
+    bool has_sequence = false;
+    uint32_t last_sequence = 0;
+
+    // 由驱动出帧节奏驱动；poll 出错（POLLERR 会立即返回）或出队失败时退避，避免空转
+    while (_is_running.load()) {
+        V4l2Device::Buffer buffer;
+        if (!_device_ptr->waitFrame(1000) || !_device_ptr->dequeue(buffer)) {
+            std::this_thread::sleep_for(retry_delay);
+            continue;
+        }
+
+        // 驱动缓冲区被下游占满时驱动会丢帧，体现为帧序号不连续（dequeue 丢弃的出错/不完整帧同样计入）
+        if (has_sequence && buffer.sequence - last_sequence > 1) {
+            _driver_dropped.fetch_add(buffer.sequence - last_sequence - 1, std::memory_order_relaxed);
+        }
+        has_sequence = true;
+        last_sequence = buffer.sequence;
+
+        // 空闲时立即归还驱动缓冲区，恢复推流时拿到的就是最新帧
+        if (_is_idle.load(std::memory_order_relaxed)) {
+            _device_ptr->enqueue(buffer.index);
+            continue;
+        }
+
+        // 帧直接引用驱动缓冲区，最后一个 FrameRef 释放时由缓冲池归还给驱动
+        FrameRef frame = _pool_ptr->acquire(buffer.index);
+        if (!frame) {
+            _device_ptr->enqueue(buffer.index);
+            continue;
+        }
+
+        if (_pixel_format == PixelFormat::YUYV) {
+            frame->mat = cv::Mat(height, width, CV_8UC2, frame.storage(), stride);
+        } else {
+            frame->mat = cv::Mat(height * 3 / 2, width, CV_8UC1, frame.storage(), stride);
+        }
+        frame->format = _pixel_format;
+        frame->width = width;
+        frame->height = height;
+        frame->timestamp_us = buffer.timestamp_us;
+
+        _frame_callback(frame);
+    }
+}
+
 void FrameCapture::capture_loop() {
-    // 约 40ms 间隔（25 FPS）
-    const auto frame_interval = std::chrono::milliseconds(40);
+    // read()/grab() 会阻塞到相机出帧，节奏由相机决定，不再固定 sleep 40ms；失败时立即返回，需要退避
+    const int width = static_cast<int>(_cap.get(cv::CAP_PROP_FRAME_WIDTH));
+    const int height = static_cast<int>(_cap.get(cv::CAP_PROP_FRAME_HEIGHT));
+    const auto retry_delay = std::chrono::milliseconds(static_cast<int64_t>(RETRY_DELAY_MS));
 
     while (_is_running.load()) {
-        auto start_time = std::chrono::steady_clock::now();
-        {
-            cv::Mat frame;
-            _cap >> frame;
-            if (!frame.empty()) {
-                _frame_callback(frame);
+        // 空闲时只取走相机帧（阻塞到出帧），不解码
+        if (_is_idle.load(std::memory_order_relaxed)) {
+            if (!_cap.grab()) {
+                std::this_thread::sleep_for(retry_delay);
+            }
+            continue;
+        }
+
+        FrameRef frame = _pool_ptr->acquire();
+        if (!frame) {
+            // 池耗尽时仍需取走相机帧，避免驱动侧堆积
+            if (!_cap.grab()) {
+                std::this_thread::sleep_for(retry_delay);
             }
+            continue;
         }
-        // 计算实际执行时间，确保稳定帧率
-        auto elapsed = std::chrono::steady_clock::now() - start_time;
-        auto sleep_time = frame_interval - elapsed;
-        if (sleep_time > std::chrono::milliseconds(0)) {
-            std::this_thread::sleep_for(sleep_time);
+
+        // Mat 头指向池内存，尺寸类型一致时 read() 直接写入，不会重新分配
+        frame->mat = cv::Mat(height, width, CV_8UC3, frame.storage());
+        if (!_cap.read(frame->mat) || frame->mat.empty()) {
+            std::this_thread::sleep_for(retry_delay);
+            continue;
         }
+        frame->format = PixelFormat::BGR24;
+        frame->width = frame->mat.cols;
+        frame->height = frame->mat.rows;
+        // OpenCV 拿不到内核时间戳，取帧返回时刻作为采集时间
+        frame->timestamp_us = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+        _frame_callback(frame);
+    }
+}
+
+void FrameCapture::setIdle(const bool is_idle) {
+    if (_is_idle.exchange(is_idle) != is_idle) {
+        _logger.iFmt("Capture %s", is_idle ? "idle" : "active");
     }
 }
 
@@ -59,6 +198,11 @@ void FrameCapture::stop() {
         _thread_ptr.reset();
     }
 
+    // 下游可能仍持有引用驱动缓冲区的帧：只停止出帧，设备（mmap）在缓冲池之后随采集器析构释放
+    if (_device_ptr) {
+        _device_ptr->stopStreaming();
+    }
+
     if (_cap.isOpened()) {
         _cap.release();
     }
@@ -66,4 +210,7 @@ void FrameCapture::stop() {
 
 FrameCapture::~FrameCapture() {
     stop();
+    // 缓冲池随采集器析构，下游持有的 FrameRef 必须在此之前全部释放；驱动缓冲区在缓冲池之后释放
+    _pool_ptr.reset();
+    _device_ptr.reset();
 }
@@ -10,32 +10,79 @@
 #include <thread>
 #include <opencv2/opencv.hpp>
 
+#include "base_config.hpp"
+#include "frame_pool.hpp"
 #include "logger.hpp"
+#include "v4l2_device.hpp"
 
 class FrameCapture {
 public:
-    using CameraFrameCallback = std::function<void(cv::Mat mat)>;
+    /**
+     * 采集回调，帧来自缓冲池，下游持有 FrameRef 即可延长生命周期，无需拷贝
+     *
+     * V4L2 采集时帧直接指向驱动的 mmap 缓冲区，最后一个 FrameRef 释放时才把缓冲区归还给驱动（QBUF），
+     * 下游长期持有会占用驱动队列，同时持有的帧数不应超过 FRAME_POOL_SIZE。
+     */
+    using CameraFrameCallback = std::function<void(const FrameRef& frame)>;
 
-    explicit FrameCapture(int index);
+    /**
+     * @param index 摄像头索引，对应 /dev/video{index}
+     * @param queue_depth V4L2 驱动队列深度（V4L2 采集时驱动缓冲区即帧缓冲池）
+     * @param pool_size 帧缓冲池槽位数（OpenCV 回退路径）
+     */
+    explicit FrameCapture(int index, uint32_t queue_depth = V4L2_BUFFER_COUNT, size_t pool_size = FRAME_POOL_SIZE);
 
     void setCameraCallback(const CameraFrameCallback& frame_callback);
 
     ~FrameCapture();
 
+    /**
+     * 优先使用 V4L2 mmap 原生采集（按 I420 > NV12 > YUYV 顺序协商 YUV 格式，不经过 BGR），
+     * 失败时回退到 cv::VideoCapture（BGR）
+     */
     bool start();
 
     void stop();
 
+    /**
+     * 空闲模式：没有拉流会话时继续取走驱动缓冲区并立即归还（保持最新），不回调下游
+     */
+    void setIdle(bool is_idle);
+
+    /**
+     * 缓冲池耗尽导致的丢帧数（V4L2 采集时为驱动缓冲区被下游占满、驱动丢弃的帧数）
+     */
+    uint64_t droppedFrames() const {
+        return (_pool_ptr ? _pool_ptr->exhaustedCount() : 0) + _driver_dropped.load(std::memory_order_relaxed);
+    }
+
 private:
+    // 取帧失败（设备错误、驱动缓冲区全部被下游占用等）时的重试间隔，避免空转占满一个核
+    static constexpr int RETRY_DELAY_MS = 10;
+
     Logger _logger;
     int _index{0};
+    uint32_t _queue_depth{V4L2_BUFFER_COUNT};
+    size_t _pool_size{FRAME_POOL_SIZE};
+    std::unique_ptr<FramePool> _pool_ptr = nullptr;
+    std::unique_ptr<V4l2Device> _device_ptr = nullptr;
+    PixelFormat _pixel_format{PixelFormat::BGR24}; // V4L2 协商得到的像素格式
     cv::VideoCapture _cap;
     std::unique_ptr<std::thread> _thread_ptr = nullptr;
     std::atomic<bool> _is_running{false};
+    std::atomic<bool> _is_idle{false};
+    // V4L2 帧序号不连续的累计帧数，只由采集线程写
+    std::atomic<uint64_t> _driver_dropped{0};
 
     // 回调函数
     CameraFrameCallback _frame_callback;
 
+    bool open_v4l2();
+
+    bool open_video_capture();
+
+    void v4l2_capture_loop();
+
     void capture_loop();
 };
 
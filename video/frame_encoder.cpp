@@ -4,10 +4,14 @@
 
 #include "frame_encoder.hpp"
 
+#include <chrono>
+#include <string>
 #include <opencv2/imgproc.hpp>
 
-#include "base_config.hpp"
-#include "ps_muxer.hpp"
+#include "copy_stats.hpp"
+#include "header_builder.hpp"
+#include "nal_splitter.hpp"
+#include "utils.hpp"
 
 extern "C" {
 #include <libavutil/frame.h>
@@ -16,142 +20,472 @@ extern "C" {
 #include <libswscale/swscale.h>
 }
 
-FrameEncoder::FrameEncoder(const size_t bufferSize) : _logger("FrameEncoder") {
-    _ringBuffer.capacity = bufferSize;
-    _ringBuffer.frames.resize(bufferSize);
+// 流水线耗时统计日志间隔
+static constexpr int64_t PIPELINE_STATS_LOG_INTERVAL_US = 30 * 1000000LL;
+// 负载调节统计窗口
+static constexpr int64_t GOVERNOR_WINDOW_US = 1000000LL;
+
+// MTU 条带上限：按最坏情况（IDR 的 PS 包）预留，RTP 负载 - PS 头(14) - 系统头和 PSM(44) - PES 头(14) - 起始码(4)
+static constexpr int MTU_SLICE_MAX_SIZE =
+        RTP_MAX_PAYLOAD - static_cast<int>(HeaderBuilder::PS_PACK_HEADER_SIZE + HeaderBuilder::PsConfig::SIZE +
+                                           HeaderBuilder::PES_HEADER_SIZE) - 4;
+// 最大的一帧按条带上限切分后（另加参数集/SEI）仍要放得进 NalSplitter 的定长 NALU 表，否则整帧（通常是 IDR）被丢弃
+static_assert(NalSplitter::MAX_FRAME_BYTES / MTU_SLICE_MAX_SIZE + 8 <= NalSplitter::MAX_NALU_PER_FRAME,
+              "MTU_SLICE_MAX_SIZE too small for NalSplitter::MAX_NALU_PER_FRAME");
+
+static int64_t steady_now_us() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
 
-    // 初始化FFmpeg
-    const AVCodec* codecPtr = avcodec_find_encoder(AV_CODEC_ID_H264);
-    if (!codecPtr) {
-        _logger.e("H.264 codec not found");
+FrameEncoder::FrameEncoder(const VideoProfile& profile, const size_t bufferSize, const FrameDropPolicy dropPolicy)
+    : _logger("FrameEncoder"),
+      _profile(profile),
+      _frame_queue(bufferSize, dropPolicy == FrameDropPolicy::DROP_OLDEST
+                                   ? SpscQueue<FrameRef>::Mode::LATEST
+                                   : SpscQueue<FrameRef>::Mode::FIFO),
+      _codec(VideoProfiles::get()->defaultCodec()),
+      _color_converter(COLOR_CONVERT_THREADS),
+      _governor(profile) {
+    if (!open_codec(_profile.width, _profile.height, _profile.bit_rate)) {
         return;
     }
 
+    // 分配流水线中循环使用的 YUV 帧
+    for (size_t i = 0; i < YUV_FRAME_COUNT; ++i) {
+        AVFrame* yuv_frame = av_frame_alloc();
+        yuv_frame->format = _codec_ctx_ptr->pix_fmt;
+        yuv_frame->width = _codec_ctx_ptr->width;
+        yuv_frame->height = _codec_ctx_ptr->height;
+        av_frame_get_buffer(yuv_frame, 0);
+        _yuv_frames.push_back(yuv_frame);
+    }
+
+    // 分配包
+    _packet_ptr = av_packet_alloc();
+
+    // SwsContext 按输入格式在编码线程中惰性创建（sws_getCachedContext）
+    _logger.iFmt("FrameEncoder created, profile: %s %dx%d %s", _profile.name.c_str(), _profile.width, _profile.height,
+                 videoCodecName(_codec));
+}
+
+bool FrameEncoder::open_codec(const int width, const int height, const int64_t bit_rate) {
+    if (_codec_ctx_ptr) {
+        avcodec_free_context(&_codec_ctx_ptr);
+    }
+
+    // 初始化FFmpeg（libx264 / libx265，下面的私有参数两者同名）
+    const AVCodec* codecPtr = avcodec_find_encoder(_codec == VideoCodec::H265 ? AV_CODEC_ID_HEVC : AV_CODEC_ID_H264);
+    if (!codecPtr) {
+        _logger.eFmt("%s codec not found", videoCodecName(_codec));
+        return false;
+    }
+
     _codec_ctx_ptr = avcodec_alloc_context3(codecPtr);
-    _codec_ctx_ptr->width = VIDEO_WIDTH;
-    _codec_ctx_ptr->height = VIDEO_HEIGHT;
-    _codec_ctx_ptr->time_base = {1, VIDEO_FPS}; // 25fps
+    _codec_ctx_ptr->width = width;
+    _codec_ctx_ptr->height = height;
+    _codec_ctx_ptr->time_base = {1, 1000000};      // pts 直接使用采集时间戳（微秒）
+    _codec_ctx_ptr->framerate = {_profile.fps, 1}; // 标称帧率，仅供码控参考
     _codec_ctx_ptr->pix_fmt = AV_PIX_FMT_YUV420P;
-    _codec_ctx_ptr->bit_rate = VIDEO_BIT_RATE; // 2Mbps
-    _codec_ctx_ptr->gop_size = VIDEO_FPS;      // GOP大小
+    _codec_ctx_ptr->bit_rate = bit_rate;
+    // 打开 VBV（最大码率 + 1 秒缓冲），libx264 只有在 VBV 开启时才支持运行中修改码率
+    _codec_ctx_ptr->rc_max_rate = bit_rate;
+    _codec_ctx_ptr->rc_buffer_size = static_cast<int>(bit_rate);
+    _codec_ctx_ptr->gop_size = VIDEO_GOP_SIZE;     // GOP大小，其余关键帧按需强制
     _codec_ctx_ptr->max_b_frames = 0;          // 实时流不用B帧
 
     // 设置编码参数
     av_opt_set(_codec_ctx_ptr->priv_data, "preset", "ultrafast", 0);
     av_opt_set(_codec_ctx_ptr->priv_data, "tune", "zerolatency", 0);
+    // pict_type = I 的帧编码为 IDR（而不是普通 I 帧），用于恢复推流/平台请求关键帧
+    av_opt_set(_codec_ctx_ptr->priv_data, "forced-idr", "1", 0);
+#if VIDEO_MTU_SLICES
+    // 条带（含起始码）连同 IDR 的 PS 头、系统头、PSM、PES 头放得进一个 RTP 包，丢包时只损坏对应条带；
+    // libx265 没有按字节限制条带的参数
+    if (_codec == VideoCodec::H264) {
+        const std::string x264_params = "slice-max-size=" + std::to_string(MTU_SLICE_MAX_SIZE);
+        av_opt_set(_codec_ctx_ptr->priv_data, "x264-params", x264_params.c_str(), 0);
+    }
+#endif
 
     if (avcodec_open2(_codec_ctx_ptr, codecPtr, nullptr) < 0) {
         _logger.e("Could not open codec");
-        return;
+        avcodec_free_context(&_codec_ctx_ptr);
+        return false;
     }
+    return true;
+}
 
-    // 分配帧和包
-    _frame_ptr = av_frame_alloc();
-    _frame_ptr->format = _codec_ctx_ptr->pix_fmt;
-    _frame_ptr->width = _codec_ctx_ptr->width;
-    _frame_ptr->height = _codec_ctx_ptr->height;
-    av_frame_get_buffer(_frame_ptr, 0);
+void FrameEncoder::pushFrame(const FrameRef& frame) {
+    if (!frame || frame->mat.empty() || !frame->mat.data)
+        return;
+    // 空闲时直接丢弃，不占用缓冲池槽位
+    if (!_is_active.load(std::memory_order_relaxed))
+        return;
 
-    // 分配包
-    _packet_ptr = av_packet_alloc();
+    // 写入帧引用（不拷贝像素）；FIFO 满时丢弃新帧，LATEST 模式覆盖未取走的旧帧，都会计入丢帧数
+    // 只有编码线程正挂起时才会触发一次 futex 唤醒
+    _frame_queue.push(frame);
+}
 
-    // 初始化SwsContext（用于BGR到YUV420P转换）
-    _sws_ctx_ptr = sws_getContext(_codec_ctx_ptr->width, _codec_ctx_ptr->height, AV_PIX_FMT_BGR24,
-                                  _codec_ctx_ptr->width, _codec_ctx_ptr->height, AV_PIX_FMT_YUV420P,
-                                  SWS_FAST_BILINEAR, nullptr, nullptr, nullptr);
-    _logger.i("FrameEncoder created");
+void FrameEncoder::setThreadAffinity(const int convert_cpu, const int encode_cpu) {
+    _convert_cpu = convert_cpu;
+    _encode_cpu = encode_cpu;
 }
 
-void FrameEncoder::pushFrame(const cv::Mat& frame) {
-    if (frame.empty() || !frame.data)
+void FrameEncoder::setActive(const bool is_active) {
+    if (is_active == _is_active.load()) {
         return;
+    }
+    if (is_active) {
+        // 先请求 IDR 再放行采集帧，保证恢复后的第一帧就是关键帧
+        requestKeyFrame();
+    }
+    _is_active = is_active;
+    _logger.iFmt("Encoder %s %s", _profile.name.c_str(), is_active ? "active" : "idle");
+}
 
-    std::unique_lock<std::mutex> lock(_mutex);
-
-    if (_ringBuffer.frames.empty()) {
-        _ringBuffer.frames.resize(_ringBuffer.capacity);
+void FrameEncoder::requestKeyFrame() {
+    _key_frame_requests.fetch_add(1, std::memory_order_relaxed);
+    if (_force_key_frame.exchange(true, std::memory_order_relaxed)) {
+        // 上一次请求尚未生效（限频中），合并为同一个 IDR
+        _key_frame_coalesced.fetch_add(1, std::memory_order_relaxed);
     }
+}
 
-    // 写入帧（覆盖旧数据）
-    _ringBuffer.frames[_ringBuffer.writeIndex] = frame.clone();
-    _ringBuffer.writeIndex = (_ringBuffer.writeIndex + 1) % _ringBuffer.capacity;
+void FrameEncoder::setCodec(const VideoCodec codec) {
+    _pending_codec.store(static_cast<int>(codec), std::memory_order_relaxed);
+}
 
-    if (_ringBuffer.count < _ringBuffer.capacity) {
-        _ringBuffer.count++;
-    } else {
-        // 缓冲区满，移动读指针（丢弃最旧帧）
-        _ringBuffer.readIndex = (_ringBuffer.readIndex + 1) % _ringBuffer.capacity;
+void FrameEncoder::setBitRate(const int64_t bit_rate) {
+    if (bit_rate > 0) {
+        _pending_bit_rate.store(bit_rate, std::memory_order_relaxed);
     }
-
-    _encode_cv.notify_one(); // 通知编码线程
 }
 
-void FrameEncoder::start(const H264DataCallback& callback) {
-    _h264_callback = callback;
+void FrameEncoder::start(const PacketCallback& callback) {
+    if (_yuv_frames.empty()) {
+        _logger.e("Encoder not initialized");
+        return;
+    }
+    _packet_callback = callback;
+
+    // 线程启动前重置两个 YUV 帧队列（此时没有并发访问），所有 YUV 帧都处于空闲状态
+    _yuv_queue.clear();
+    _free_yuv_queue.clear();
+    for (AVFrame* yuv_frame : _yuv_frames) {
+        _free_yuv_queue.push(yuv_frame);
+    }
+    _last_stats_log_us = steady_now_us();
+    _last_governor_us = _last_stats_log_us;
+
     _is_running = true;
+    _convert_thread_ptr = std::make_unique<std::thread>(&FrameEncoder::convert_loop, this);
     _encode_thread_ptr = std::make_unique<std::thread>(&FrameEncoder::encode_loop, this);
+    Utils::get()->bindThreadToCpu(*_convert_thread_ptr, _convert_cpu);
+    Utils::get()->bindThreadToCpu(*_encode_thread_ptr, _encode_cpu);
 }
 
-void FrameEncoder::encode_loop() {
+void FrameEncoder::convert_loop() {
+    FrameRef frame;
+    AVFrame* yuv_frame = nullptr;
     while (_is_running) {
-        std::unique_lock<std::mutex> lock(_mutex);
+        // 先拿到空闲 YUV 帧再取采集帧：编码阶段较慢时在这里等待，采集队列继续按丢帧策略保留最新帧
+        if (!yuv_frame && !_free_yuv_queue.waitPop(yuv_frame, 100)) {
+            continue;
+        }
+        // 队列为空时挂起等待，stop() 会主动唤醒
+        if (!_frame_queue.waitPop(frame, 100)) {
+            continue;
+        }
+        // 切到空闲前已入队的旧帧直接丢弃，避免恢复推流时先编码一帧过期画面
+        if (!_is_active.load(std::memory_order_relaxed)) {
+            frame.reset();
+            continue;
+        }
+
+        // 负载调节降帧率：按比例均匀跳过采集帧，跳过的帧不做转换也不编码
+        const auto& level = _governor.level();
+        _decimate_acc += level.fps_num;
+        if (_decimate_acc < level.fps_den) {
+            frame.reset();
+            continue;
+        }
+        _decimate_acc -= level.fps_den;
+
+        const int64_t begin_us = steady_now_us();
+        // 负载调节降分辨率：编码尺寸变化时按新尺寸重新分配 YUV 帧（编码线程据此重建编码器）
+        const int width = _governor.width();
+        const int height = _governor.height();
+        if (yuv_frame->width != width || yuv_frame->height != height) {
+            av_frame_unref(yuv_frame);
+            yuv_frame->format = AV_PIX_FMT_YUV420P;
+            yuv_frame->width = width;
+            yuv_frame->height = height;
+            av_frame_get_buffer(yuv_frame, 0);
+        }
+        // 确保AVFrame可写（编码器可能仍持有上一轮的引用，此时会重新分配缓冲区）
+        const bool is_filled = av_frame_make_writable(yuv_frame) >= 0 && fill_yuv_frame(*frame, yuv_frame);
+        if (is_filled) {
+            // 采集时间戳作为 pts，无 B 帧时输出包的 pts 与输入一致
+            yuv_frame->pts = frame->timestamp_us;
+        }
+        // 转换结束后引用释放，槽位回到缓冲池
+        frame.reset();
+        if (!is_filled) {
+            // 转换失败时 YUV 帧留在本线程下一轮复用（空闲队列只能由编码线程写入）
+            continue;
+        }
+        _convert_timer.record(static_cast<uint64_t>(steady_now_us() - begin_us));
 
-        // 等待有数据或停止信号
-        _encode_cv.wait(lock, [this] {
-            return !_is_running || _ringBuffer.count > 0;
-        });
+        _yuv_queue.push(yuv_frame);
+        yuv_frame = nullptr;
+    }
+}
 
-        if (!_is_running)
-            break;
+void FrameEncoder::encode_loop() {
+    AVFrame* yuv_frame = nullptr;
+    while (_is_running) {
+        if (!_yuv_queue.waitPop(yuv_frame, 100)) {
+            continue;
+        }
 
-        // 处理所有待编码帧
-        while (_ringBuffer.count > 0 && _is_running) {
-            // 取出帧（不阻塞）
-            cv::Mat frame = _ringBuffer.frames[_ringBuffer.readIndex];
-            _ringBuffer.readIndex = (_ringBuffer.readIndex + 1) % _ringBuffer.capacity;
-            _ringBuffer.count--;
+        const int64_t begin_us = steady_now_us();
+        encode_frame(yuv_frame);
+        const int64_t end_us = steady_now_us();
+        _encode_timer.record(static_cast<uint64_t>(end_us - begin_us));
 
-            lock.unlock(); // 释放锁，允许pushFrame
+        // 归还给转换线程
+        _free_yuv_queue.push(yuv_frame);
 
-            // 执行编码（耗时操作，不持有锁）
-            encode_frame(frame);
+#if ENCODE_GOVERNOR_ENABLE
+        if (end_us - _last_governor_us >= GOVERNOR_WINDOW_US) {
+            update_governor();
+            _last_governor_us = end_us;
+        }
+#endif
 
-            lock.lock(); // 重新加锁
+        if (end_us - _last_stats_log_us >= PIPELINE_STATS_LOG_INTERVAL_US) {
+            log_pipeline_stats();
+            _last_stats_log_us = end_us;
         }
     }
 }
 
-void FrameEncoder::encode_frame(const cv::Mat& frame) const {
-    // 确保AVFrame可写
-    if (av_frame_make_writable(_frame_ptr) < 0) {
-        _logger.e("Could not make frame writable");
-        return;
+bool FrameEncoder::fill_yuv_frame(const VideoFrame& frame, AVFrame* yuv_frame) {
+    const uint8_t* data = frame.mat.data;
+    const int stride = static_cast<int>(frame.mat.step[0]);
+    const int width = frame.width;
+    const int height = frame.height;
+
+    const uint8_t* src_slice[4] = {nullptr, nullptr, nullptr, nullptr};
+    int src_stride[4] = {0, 0, 0, 0};
+    AVPixelFormat src_format;
+    switch (frame.format) {
+        case PixelFormat::I420:
+            src_format = AV_PIX_FMT_YUV420P;
+            src_slice[0] = data;
+            src_slice[1] = data + stride * height;
+            src_slice[2] = src_slice[1] + (stride / 2) * (height / 2);
+            src_stride[0] = stride;
+            src_stride[1] = stride / 2;
+            src_stride[2] = stride / 2;
+            break;
+        case PixelFormat::NV12:
+            src_format = AV_PIX_FMT_NV12;
+            src_slice[0] = data;
+            src_slice[1] = data + stride * height;
+            src_stride[0] = stride;
+            src_stride[1] = stride;
+            break;
+        case PixelFormat::YUYV:
+            src_format = AV_PIX_FMT_YUYV422;
+            src_slice[0] = data;
+            src_stride[0] = stride;
+            break;
+        case PixelFormat::BGR24:
+        default:
+            src_format = AV_PIX_FMT_BGR24;
+            src_slice[0] = data;
+            src_stride[0] = stride;
+            break;
+    }
+
+    // 目标尺寸取 YUV 帧自身（负载调节可能降低了分辨率），编码器上下文只由编码线程访问
+    const int dst_width = yuv_frame->width;
+    const int dst_height = yuv_frame->height;
+
+    // I420 且尺寸一致：布局与编码器相同，逐平面拷贝即可，无需任何颜色转换
+    if (src_format == AV_PIX_FMT_YUV420P && width == dst_width && height == dst_height) {
+        av_image_copy_plane(yuv_frame->data[0], yuv_frame->linesize[0], src_slice[0], src_stride[0],
+                            width, height);
+        av_image_copy_plane(yuv_frame->data[1], yuv_frame->linesize[1], src_slice[1], src_stride[1],
+                            width / 2, height / 2);
+        av_image_copy_plane(yuv_frame->data[2], yuv_frame->linesize[2], src_slice[2], src_stride[2],
+                            width / 2, height / 2);
+        return true;
+    }
+
+    // 同尺寸的 NV12（解交错色度）/ YUYV（色度下采样）/ BGR（完整转换）走 SIMD 并行转换
+    if (width == dst_width && height == dst_height &&
+        _color_converter.toI420(frame, yuv_frame->data, yuv_frame->linesize)) {
+        return true;
+    }
+
+    // 需要缩放（子码流，或采集分辨率与编码分辨率不一致）或奇数尺寸时交给 sws_scale，缩放与颜色转换一次完成
+    _sws_ctx_ptr = sws_getCachedContext(_sws_ctx_ptr, width, height, src_format,
+                                        dst_width, dst_height, AV_PIX_FMT_YUV420P,
+                                        SWS_FAST_BILINEAR, nullptr, nullptr, nullptr);
+    if (!_sws_ctx_ptr) {
+        _logger.e("Could not create SwsContext");
+        return false;
+    }
+    sws_scale(_sws_ctx_ptr, src_slice, src_stride, 0, height, yuv_frame->data, yuv_frame->linesize);
+    return true;
+}
+
+void FrameEncoder::encode_frame(AVFrame* yuv_frame) {
+    // 切换了编码格式，或负载调节切换了分辨率：重建编码器（沿用当前码率），第一帧即为带参数集的 IDR
+    const int pending_codec = _pending_codec.exchange(-1, std::memory_order_relaxed);
+    const bool is_codec_changed = pending_codec >= 0 && static_cast<VideoCodec>(pending_codec) != _codec;
+    if (is_codec_changed) {
+        _codec = static_cast<VideoCodec>(pending_codec);
+    }
+    if (!_codec_ctx_ptr || is_codec_changed || yuv_frame->width != _codec_ctx_ptr->width ||
+        yuv_frame->height != _codec_ctx_ptr->height) {
+        const int64_t bit_rate = _codec_ctx_ptr ? _codec_ctx_ptr->bit_rate : _profile.bit_rate;
+        _logger.iFmt("Reopen encoder %s: %s %dx%d", _profile.name.c_str(), videoCodecName(_codec), yuv_frame->width,
+                     yuv_frame->height);
+        if (!open_codec(yuv_frame->width, yuv_frame->height, bit_rate)) {
+            // 丢弃本帧，下一帧重试
+            return;
+        }
     }
 
-    // BGR到YUV420P转换
-    const uint8_t* srcSlice[1] = {frame.data};
-    const int srcStride[1] = {static_cast<int>(frame.step[0])};
+    // 码率调整在编码线程内生效，x264 在下一帧重新配置码控（需要 VBV，见 open_codec）；
+    // libx265 不支持运行中修改码率，新码率在下一次重建编码器时生效
+    const int64_t bit_rate = _pending_bit_rate.exchange(0, std::memory_order_relaxed);
+    if (bit_rate > 0 && bit_rate != _codec_ctx_ptr->bit_rate) {
+        _logger.iFmt("Bitrate %s: %lld -> %lld", _profile.name.c_str(),
+                     static_cast<long long>(_codec_ctx_ptr->bit_rate), static_cast<long long>(bit_rate));
+        _codec_ctx_ptr->bit_rate = bit_rate;
+        _codec_ctx_ptr->rc_max_rate = bit_rate;
+        _codec_ctx_ptr->rc_buffer_size = static_cast<int>(bit_rate);
+    }
 
-    sws_scale(_sws_ctx_ptr, srcSlice, srcStride, 0, frame.rows, _frame_ptr->data, _frame_ptr->linesize);
+    // 强制 IDR 限频：距上一次强制 IDR 不足最小间隔时请求保持挂起，间隔到了再生效
+    bool is_key_frame = false;
+    if (_force_key_frame.load(std::memory_order_relaxed)) {
+        const int64_t now_us = steady_now_us();
+        if (now_us - _last_forced_key_us >= FORCED_IDR_MIN_INTERVAL_MS * 1000LL) {
+            _force_key_frame.store(false, std::memory_order_relaxed);
+            _last_forced_key_us = now_us;
+            is_key_frame = true;
+            _logger.dFmt("Forced IDR on %s", _profile.name.c_str());
+        }
+    }
+    // YUV 帧循环使用，每帧都要重置帧类型
+    yuv_frame->pict_type = is_key_frame ? AV_PICTURE_TYPE_I : AV_PICTURE_TYPE_NONE;
 
     // 发送帧给编码器
-    if (avcodec_send_frame(_codec_ctx_ptr, _frame_ptr) < 0) {
+    if (avcodec_send_frame(_codec_ctx_ptr, yuv_frame) < 0) {
         _logger.e("Error sending frame to encoder");
         return;
     }
 
     // 接收编码后的包
     while (avcodec_receive_packet(_codec_ctx_ptr, _packet_ptr) >= 0) {
-        const std::vector<uint8_t> h264Buffer(_packet_ptr->data, _packet_ptr->data + _packet_ptr->size);
-        _h264_callback(h264Buffer);
+        // 接管 AVPacket 的缓冲区引用，_packet_ptr 被重置为空包，码流数据不拷贝
+        bool is_copied = false;
+        const EncodedPacketPtr packet = EncodedPacket::takeFrom(_packet_ptr, _codec, is_copied);
         av_packet_unref(_packet_ptr);
+        if (!packet) {
+            continue;
+        }
+        if (packet->size() > NalSplitter::MAX_FRAME_BYTES) {
+            // 超过单帧上限的帧无法封装，码率或画面复杂度异常
+            _logger.wFmt("Encoded frame of %zu bytes exceeds the %zu byte limit and will be dropped", packet->size(),
+                         static_cast<size_t>(NalSplitter::MAX_FRAME_BYTES));
+        }
+        CopyStats::get()->onFrame(packet->size());
+        if (is_copied) {
+            CopyStats::get()->onCopy(CopyStage::ENCODER_OUTPUT, packet->size());
+        }
+        _packet_callback(packet);
+    }
+}
+
+void FrameEncoder::StageTimer::record(const uint64_t elapsed_us) {
+    frames.fetch_add(1, std::memory_order_relaxed);
+    total_us.fetch_add(elapsed_us, std::memory_order_relaxed);
+    if (elapsed_us > max_us.load(std::memory_order_relaxed)) {
+        max_us.store(elapsed_us, std::memory_order_relaxed);
+    }
+}
+
+FrameEncoder::StageStats FrameEncoder::StageTimer::snapshot() const {
+    StageStats stats;
+    stats.frames = frames.load(std::memory_order_relaxed);
+    if (stats.frames > 0) {
+        stats.avg_ms = static_cast<double>(total_us.load(std::memory_order_relaxed)) / stats.frames / 1000.0;
     }
+    stats.max_ms = static_cast<double>(max_us.load(std::memory_order_relaxed)) / 1000.0;
+    return stats;
+}
+
+void FrameEncoder::update_governor() {
+    // 取两个阶段在本窗口内的增量
+    EncodeGovernor::Sample total;
+    total.convert_frames = _convert_timer.frames.load(std::memory_order_relaxed);
+    total.convert_us = _convert_timer.total_us.load(std::memory_order_relaxed);
+    total.encode_frames = _encode_timer.frames.load(std::memory_order_relaxed);
+    total.encode_us = _encode_timer.total_us.load(std::memory_order_relaxed);
+
+    EncodeGovernor::Sample window;
+    window.convert_frames = total.convert_frames - _governor_total.convert_frames;
+    window.convert_us = total.convert_us - _governor_total.convert_us;
+    window.encode_frames = total.encode_frames - _governor_total.encode_frames;
+    window.encode_us = total.encode_us - _governor_total.encode_us;
+    _governor_total = total;
+
+    _governor.update(window);
+}
+
+FrameEncoder::PipelineStats FrameEncoder::pipelineStats() const {
+    PipelineStats stats;
+    stats.convert = _convert_timer.snapshot();
+    stats.encode = _encode_timer.snapshot();
+    return stats;
+}
+
+void FrameEncoder::log_pipeline_stats() {
+    const auto stats = pipelineStats();
+    _logger.dBox()
+           .addFmt("编码流水线统计（%s）", _profile.name.c_str())
+           .addFmt("转换: %llu 帧，平均 %.2f ms，最大 %.2f ms",
+                   static_cast<unsigned long long>(stats.convert.frames), stats.convert.avg_ms, stats.convert.max_ms)
+           .addFmt("编码: %llu 帧，平均 %.2f ms，最大 %.2f ms",
+                   static_cast<unsigned long long>(stats.encode.frames), stats.encode.avg_ms, stats.encode.max_ms)
+           .addFmt("采集丢帧: %llu", static_cast<unsigned long long>(droppedFrames()))
+           .addFmt("关键帧请求: %llu 次，限频合并 %llu 次",
+                   static_cast<unsigned long long>(_key_frame_requests.load(std::memory_order_relaxed)),
+                   static_cast<unsigned long long>(_key_frame_coalesced.load(std::memory_order_relaxed)))
+           .addFmt("负载调节: %s（负载 %.2f），降级 %llu 次，升级 %llu 次", _governor.level().name, _governor.load(),
+                   static_cast<unsigned long long>(_governor.stepDowns()),
+                   static_cast<unsigned long long>(_governor.stepUps()))
+           .print();
 }
 
 void FrameEncoder::stop() {
     _is_running = false;
     // 唤醒等待线程
-    _encode_cv.notify_all();
+    _frame_queue.wakeConsumer();
+    _free_yuv_queue.wakeConsumer();
+    _yuv_queue.wakeConsumer();
+    if (_convert_thread_ptr && _convert_thread_ptr->joinable()) {
+        _convert_thread_ptr->join();
+        _convert_thread_ptr.reset();
+    }
     if (_encode_thread_ptr && _encode_thread_ptr->joinable()) {
         _encode_thread_ptr->join();
         _encode_thread_ptr.reset();
@@ -166,9 +500,10 @@ FrameEncoder::~FrameEncoder() {
     if (_codec_ctx_ptr) {
         avcodec_free_context(&_codec_ctx_ptr);
     }
-    if (_frame_ptr) {
-        av_frame_free(&_frame_ptr);
+    for (AVFrame*& yuv_frame : _yuv_frames) {
+        av_frame_free(&yuv_frame);
     }
+    _yuv_frames.clear();
     if (_packet_ptr) {
         av_packet_free(&_packet_ptr);
     }
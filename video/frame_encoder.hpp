@@ -6,61 +6,218 @@
 #define GB28181CONSOLE_FRAME_ENCODER_HPP
 
 #include <atomic>
-#include <condition_variable>
-#include <mutex>
 #include <thread>
 #include <functional>
 #include <opencv2/core/mat.hpp>
 
+#include "base_config.hpp"
+#include "color_converter.hpp"
+#include "encode_governor.hpp"
+#include "encoded_packet.hpp"
+#include "frame_pool.hpp"
 #include "logger.hpp"
+#include "spsc_queue.hpp"
+#include "video_profile.hpp"
 
 extern "C" {
 #include <libavcodec/avcodec.h>
 #include <libswscale/swscale.h>
 }
 
+/**
+ * 视频编码器（两级流水线），每个编码档位（主/子码流）一个实例
+ *
+ * 采集帧 -> [转换线程：颜色转换到 YUV420P] -> YUV 帧队列 -> [编码线程：x264 编码] -> 回调
+ *
+ * 两个阶段各自独占线程（可分别绑核），通过少量预分配的 YUV 帧循环使用：转换线程在编码第 N 帧时
+ * 就可以转换第 N+1 帧，吞吐由较慢的阶段决定，而不是两者之和。
+ * */
 class FrameEncoder {
 public:
-    using H264DataCallback = std::function<void(const std::vector<uint8_t>&)>;
-
-    explicit FrameEncoder(size_t bufferSize = 3);
-
-    // 生产者：快速写入
-    void pushFrame(const cv::Mat& frame);
-
-    void start(const H264DataCallback& callback);
+    /**
+     * 编码输出回调：完整的一帧码流（H.264 / H.265，带起始码，引用计数，不拷贝），采集时间戳见 EncodedPacket::captureUs()
+     */
+    using PacketCallback = std::function<void(const EncodedPacketPtr&)>;
+
+    /**
+     * 单个流水线阶段的耗时统计
+     */
+    struct StageStats {
+        uint64_t frames = 0; // 已处理帧数
+        double avg_ms = 0;   // 平均耗时
+        double max_ms = 0;   // 最大耗时
+    };
+
+    struct PipelineStats {
+        StageStats convert; // 颜色转换
+        StageStats encode;  // 编码（含输出回调）
+    };
+
+    /**
+     * @param profile 编码档位（分辨率、帧率、码率）
+     * @param bufferSize 待编码队列容量（DROP_NEWEST 时有效）
+     * @param dropPolicy 丢帧策略：DROP_OLDEST = 最新帧优先，DROP_NEWEST = 有界 FIFO
+     */
+    explicit FrameEncoder(const VideoProfile& profile, size_t bufferSize = 3,
+                          FrameDropPolicy dropPolicy = FrameDropPolicy::DROP_OLDEST);
+
+    const VideoProfile& profile() const {
+        return _profile;
+    }
+
+    // 生产者：快速写入（只增加引用计数，不拷贝像素，无锁），只允许采集线程调用
+    void pushFrame(const FrameRef& frame);
+
+    /**
+     * 队列满/被新帧覆盖导致的丢帧数
+     */
+    uint64_t droppedFrames() const {
+        return _frame_queue.droppedCount();
+    }
+
+    /**
+     * 设置两个阶段线程绑定的 CPU 核，需在 start() 之前调用
+     *
+     * @param convert_cpu 转换线程 CPU，-1 表示不绑定
+     * @param encode_cpu 编码线程 CPU，-1 表示不绑定
+     */
+    void setThreadAffinity(int convert_cpu, int encode_cpu);
+
+    PipelineStats pipelineStats() const;
+
+    /**
+     * 调整目标码率（任意线程调用），在编码线程处理下一帧前生效
+     *
+     * @param bit_rate 目标码率（bps）
+     */
+    void setBitRate(int64_t bit_rate);
+
+    /**
+     * 切换工作/空闲状态（任意线程调用）
+     *
+     * 空闲时编码器上下文保持打开，但不再接收、转换和编码采集帧；
+     * 恢复工作时强制下一帧为 IDR，平台可立即解码出画面。
+     */
+    void setActive(bool is_active);
+
+    bool isActive() const {
+        return _is_active.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * 请求下一帧编码为 IDR（任意线程调用）
+     *
+     * 限频：距上一次强制 IDR 不足 FORCED_IDR_MIN_INTERVAL_MS 时，请求推迟到间隔结束，期间的多次请求只产生一个 IDR
+     */
+    void requestKeyFrame();
+
+    /**
+     * 切换编码格式（任意线程调用），编码线程在下一帧按新格式重建编码器，第一帧为 IDR
+     */
+    void setCodec(VideoCodec codec);
+
+    /**
+     * 编码负载调节器（当前降级级别、升降级次数）
+     */
+    const EncodeGovernor& governor() const {
+        return _governor;
+    }
+
+    void start(const PacketCallback& callback);
 
     void stop();
 
     ~FrameEncoder();
 
 private:
-    struct FrameBuffer {
-        std::vector<cv::Mat> frames; // 预分配的帧缓冲区
-        size_t writeIndex = 0;       // 写入位置
-        size_t readIndex = 0;        // 读取位置
-        size_t count = 0;            // 当前帧数
-        size_t capacity;             // 容量
-    } _ringBuffer;
+    // 流水线中循环使用的 YUV 帧个数：转换中 1 + 排队 1 + 编码中 1
+    static constexpr size_t YUV_FRAME_COUNT = 3;
+
+    /**
+     * 阶段耗时累加器，单线程写、任意线程读
+     */
+    struct StageTimer {
+        std::atomic<uint64_t> frames{0};
+        std::atomic<uint64_t> total_us{0};
+        std::atomic<uint64_t> max_us{0};
+
+        void record(uint64_t elapsed_us);
+
+        StageStats snapshot() const;
+    };
 
     Logger _logger;
+    const VideoProfile _profile;
 
+    // 采集 -> 转换 的无锁单生产者/单消费者队列
+    SpscQueue<FrameRef> _frame_queue;
+
+    // 当前编码格式，只由编码线程访问；_pending_codec 为待切换的格式，-1 表示无变化
+    VideoCodec _codec;
+    std::atomic<int> _pending_codec{-1};
     AVCodecContext* _codec_ctx_ptr = nullptr;
-    AVFrame* _frame_ptr = nullptr;
     AVPacket* _packet_ptr = nullptr;
     SwsContext* _sws_ctx_ptr = nullptr;
 
-    // 编码相关
+    // 同尺寸颜色转换（SIMD + 行带并行），尺寸不一致时才回退到 sws_scale
+    ColorConverter _color_converter;
+
+    // 转换 -> 编码：已填充的 YUV 帧；编码 -> 转换：用完归还的 YUV 帧
+    std::vector<AVFrame*> _yuv_frames;
+    SpscQueue<AVFrame*> _yuv_queue{YUV_FRAME_COUNT};
+    SpscQueue<AVFrame*> _free_yuv_queue{YUV_FRAME_COUNT};
+
+    // 流水线线程
+    std::unique_ptr<std::thread> _convert_thread_ptr = nullptr;
     std::unique_ptr<std::thread> _encode_thread_ptr = nullptr;
-    std::mutex _mutex;
     std::atomic<bool> _is_running{false};
-    std::condition_variable _encode_cv;
+    int _convert_cpu = CONVERT_THREAD_CPU;
+    int _encode_cpu = ENCODE_THREAD_CPU;
+
+    // 空闲时不接收采集帧
+    std::atomic<bool> _is_active{true};
+    // 下一帧强制 IDR
+    std::atomic<bool> _force_key_frame{false};
+    std::atomic<uint64_t> _key_frame_requests{0};
+    std::atomic<uint64_t> _key_frame_coalesced{0};
+    // 上一次强制 IDR 的时刻，只由编码线程访问
+    int64_t _last_forced_key_us = 0;
+
+    // 待生效的目标码率，0 表示无变化
+    std::atomic<int64_t> _pending_bit_rate{0};
+
+    StageTimer _convert_timer;
+    StageTimer _encode_timer;
+    int64_t _last_stats_log_us = 0;
+
+    // 算力不足时降帧率/分辨率，只由编码线程更新
+    EncodeGovernor _governor;
+    EncodeGovernor::Sample _governor_total;
+    int64_t _last_governor_us = 0;
+    // 降帧率时的均匀抽帧累加器，只由转换线程访问
+    int _decimate_acc = 0;
+
+    /**
+     * 按指定尺寸（重新）创建编码器
+     */
+    bool open_codec(int width, int height, int64_t bit_rate);
+
+    void convert_loop();
 
     void encode_loop();
 
-    void encode_frame(const cv::Mat& frame) const;
+    void encode_frame(AVFrame* yuv_frame);
+
+    /**
+     * 按采集格式把帧转换/拷贝到编码器的 YUV420P AVFrame，只在色度布局不同时才做转换
+     */
+    bool fill_yuv_frame(const VideoFrame& frame, AVFrame* yuv_frame);
+
+    void update_governor();
+
+    void log_pipeline_stats();
 
-    H264DataCallback _h264_callback;
+    PacketCallback _packet_callback;
 };
 
 
@@ -0,0 +1,121 @@
+//
+// Created by pengx on 2026/10/16.
+//
+
+#include "frame_pool.hpp"
+
+#include <utility>
+
+// ============================================================
+// FrameRef
+// ============================================================
+FrameRef::FrameRef(PooledFrame* slot) : _slot(slot) {
+    if (_slot) {
+        _slot->ref_count.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+FrameRef::FrameRef(const FrameRef& other) : FrameRef(other._slot) {}
+
+FrameRef::FrameRef(FrameRef&& other) noexcept : _slot(other._slot) {
+    other._slot = nullptr;
+}
+
+FrameRef& FrameRef::operator=(const FrameRef& other) {
+    if (this != &other) {
+        FrameRef tmp(other);
+        std::swap(_slot, tmp._slot);
+    }
+    return *this;
+}
+
+FrameRef& FrameRef::operator=(FrameRef&& other) noexcept {
+    if (this != &other) {
+        reset();
+        _slot = other._slot;
+        other._slot = nullptr;
+    }
+    return *this;
+}
+
+FrameRef::~FrameRef() {
+    reset();
+}
+
+void FrameRef::reset() {
+    if (!_slot) {
+        return;
+    }
+    if (_slot->ref_count.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        _slot->pool->release(_slot);
+    }
+    _slot = nullptr;
+}
+
+// ============================================================
+// FramePool
+// ============================================================
+FramePool::FramePool(const size_t capacity, const size_t frame_bytes) : _frame_bytes(frame_bytes) {
+    _slots.reserve(capacity);
+    _free_slots.reserve(capacity);
+    for (size_t i = 0; i < capacity; ++i) {
+        auto slot = std::make_unique<PooledFrame>();
+        slot->storage.resize(frame_bytes);
+        slot->data = slot->storage.data();
+        slot->size = frame_bytes;
+        slot->index = static_cast<uint32_t>(i);
+        slot->pool = this;
+        _free_slots.push_back(slot.get());
+        _slots.push_back(std::move(slot));
+    }
+}
+
+FramePool::FramePool(const std::vector<ExternalBuffer>& buffers, ReleaseCallback on_release)
+    : _frame_bytes(buffers.empty() ? 0 : buffers.front().size), _on_release(std::move(on_release)) {
+    _slots.reserve(buffers.size());
+    for (size_t i = 0; i < buffers.size(); ++i) {
+        auto slot = std::make_unique<PooledFrame>();
+        slot->data = buffers[i].data;
+        slot->size = buffers[i].size;
+        slot->index = static_cast<uint32_t>(i);
+        slot->pool = this;
+        _slots.push_back(std::move(slot));
+    }
+}
+
+FrameRef FramePool::acquire() {
+    PooledFrame* slot = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (!_free_slots.empty()) {
+            slot = _free_slots.back();
+            _free_slots.pop_back();
+        }
+    }
+    if (!slot) {
+        _exhausted_count.fetch_add(1, std::memory_order_relaxed);
+        return FrameRef();
+    }
+    return FrameRef(slot);
+}
+
+FrameRef FramePool::acquire(const uint32_t index) {
+    if (index >= _slots.size()) {
+        return FrameRef();
+    }
+    return FrameRef(_slots[index].get());
+}
+
+size_t FramePool::available() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _free_slots.size();
+}
+
+void FramePool::release(PooledFrame* slot) {
+    if (_on_release) {
+        _on_release(slot->index);
+        return;
+    }
+    std::lock_guard<std::mutex> lock(_mutex);
+    _free_slots.push_back(slot);
+}
@@ -0,0 +1,172 @@
+//
+// Created by pengx on 2026/10/16.
+//
+
+#ifndef GB28181CONSOLE_FRAME_POOL_HPP
+#define GB28181CONSOLE_FRAME_POOL_HPP
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "video_frame.hpp"
+
+/**
+ * 缓冲区耗尽（或下游队列已满）时的丢帧策略
+ */
+enum class FrameDropPolicy {
+    DROP_OLDEST, // 丢弃最旧的待处理帧，保证画面最新（实时预览/推流，编码队列退化为“最新帧优先”）
+    DROP_NEWEST  // 丢弃新到的帧，保证已排队的帧按序处理（编码队列为有界 FIFO）
+};
+
+class FramePool;
+
+/**
+ * 池中的一个帧槽位：像素内存（预分配，或外部缓冲区如 V4L2 mmap）+ 帧描述 + 引用计数
+ */
+struct PooledFrame {
+    VideoFrame frame;              // frame.mat 指向 data，不单独持有内存
+    std::vector<uint8_t> storage;  // 池自己分配的像素内存，外部缓冲区时为空
+    uint8_t* data = nullptr;       // 像素内存：storage 或外部缓冲区
+    size_t size = 0;
+    uint32_t index = 0;            // 槽位序号（外部缓冲区时即缓冲区索引）
+    std::atomic<int> ref_count{0}; // 引用计数，归零时回收到池
+    FramePool* pool = nullptr;
+};
+
+/**
+ * 帧引用（侵入式引用计数句柄）
+ *
+ * 拷贝只增加引用计数，不拷贝像素数据，也不分配内存；最后一个引用析构时槽位回到池中。
+ * */
+class FrameRef {
+public:
+    FrameRef() = default;
+
+    explicit FrameRef(PooledFrame* slot);
+
+    FrameRef(const FrameRef& other);
+
+    FrameRef(FrameRef&& other) noexcept;
+
+    FrameRef& operator=(const FrameRef& other);
+
+    FrameRef& operator=(FrameRef&& other) noexcept;
+
+    ~FrameRef();
+
+    void reset();
+
+    explicit operator bool() const {
+        return _slot != nullptr;
+    }
+
+    VideoFrame& operator*() const {
+        return _slot->frame;
+    }
+
+    VideoFrame* operator->() const {
+        return &_slot->frame;
+    }
+
+    uint8_t* storage() const {
+        return _slot->data;
+    }
+
+    size_t capacity() const {
+        return _slot->size;
+    }
+
+private:
+    PooledFrame* _slot = nullptr;
+};
+
+/**
+ * 固定大小的帧缓冲池
+ *
+ * 启动时一次性分配所有槽位，稳态运行不再有任何内存分配。采集线程 acquire() 一个空闲槽位并填充，
+ * 编码线程持有 FrameRef 直接使用，用完自动归还。
+ *
+ * 也可以包装外部缓冲区（V4L2 mmap 缓冲区）：槽位不分配内存，按缓冲区索引 acquire(index) 取出，
+ * 最后一个引用释放时调用 ReleaseCallback 把缓冲区还给外部（重新 QBUF），像素数据全程不拷贝。
+ * */
+class FramePool {
+public:
+    /**
+     * 外部缓冲区
+     */
+    struct ExternalBuffer {
+        uint8_t* data = nullptr;
+        size_t size = 0;
+    };
+
+    /**
+     * 外部缓冲区的最后一个引用释放（可能在任意线程），index 为缓冲区索引
+     */
+    using ReleaseCallback = std::function<void(uint32_t index)>;
+
+    /**
+     * @param capacity 槽位个数
+     * @param frame_bytes 每个槽位的像素内存大小
+     */
+    FramePool(size_t capacity, size_t frame_bytes);
+
+    /**
+     * 包装外部缓冲区，槽位 i 对应 buffers[i]
+     *
+     * @param on_release 最后一个引用释放时调用，外部缓冲区必须在池析构前保持有效
+     */
+    FramePool(const std::vector<ExternalBuffer>& buffers, ReleaseCallback on_release);
+
+    FramePool(const FramePool&) = delete;
+
+    FramePool& operator=(const FramePool&) = delete;
+
+    /**
+     * 获取一个空闲槽位
+     *
+     * @return 池耗尽时返回空引用，并计入 exhaustedCount()
+     */
+    FrameRef acquire();
+
+    /**
+     * 按缓冲区索引取出外部缓冲区槽位（外部已把缓冲区交给调用方，槽位必然空闲）
+     *
+     * @return 索引越界时返回空引用
+     */
+    FrameRef acquire(uint32_t index);
+
+    bool isExternal() const {
+        return static_cast<bool>(_on_release);
+    }
+
+    size_t capacity() const {
+        return _slots.size();
+    }
+
+    size_t frameBytes() const {
+        return _frame_bytes;
+    }
+
+    size_t available();
+
+    uint64_t exhaustedCount() const {
+        return _exhausted_count.load(std::memory_order_relaxed);
+    }
+
+private:
+    friend class FrameRef;
+
+    const size_t _frame_bytes;
+    std::vector<std::unique_ptr<PooledFrame>> _slots;
+    std::vector<PooledFrame*> _free_slots; // 预留容量，push/pop 不会分配（外部缓冲区时不使用）
+    ReleaseCallback _on_release;
+    std::mutex _mutex;
+    std::atomic<uint64_t> _exhausted_count{0};
+
+    void release(PooledFrame* slot);
+};
+
+#endif //GB28181CONSOLE_FRAME_POOL_HPP
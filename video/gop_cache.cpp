@@ -0,0 +1,33 @@
+//
+// Created by pengx on 2026/10/16.
+//
+
+#include "gop_cache.hpp"
+
+GopCache::GopCache(const size_t max_frames) : _max_frames(max_frames) {
+    _packets.reserve(max_frames);
+}
+
+void GopCache::push(const EncodedPacketPtr& packet) {
+    if (!packet) {
+        return;
+    }
+    if (packet->isKeyFrame()) {
+        _packets.clear();
+        _packets.push_back(packet);
+        return;
+    }
+    if (_packets.empty()) {
+        return;
+    }
+    if (_packets.size() >= _max_frames) {
+        // GOP 比预期长，不完整的组不能回放
+        _packets.clear();
+        return;
+    }
+    _packets.push_back(packet);
+}
+
+void GopCache::clear() {
+    _packets.clear();
+}
@@ -0,0 +1,45 @@
+//
+// Created by pengx on 2026/10/16.
+//
+
+#ifndef GB28181CONSOLE_GOP_CACHE_HPP
+#define GB28181CONSOLE_GOP_CACHE_HPP
+
+#include <vector>
+
+#include "encoded_packet.hpp"
+
+/**
+ * 当前 GOP 缓存：最近一个 IDR（自带 SPS/PPS）及其后的 P 帧，只保存引用计数，不拷贝码流
+ *
+ * 新会话开始时整体回放，平台无需等待下一个自然 IDR 即可解码出画面。
+ * 不加锁，由使用方（PsMuxer）的锁保护。
+ * */
+class GopCache {
+public:
+    /**
+     * @param max_frames 最多缓存的帧数，超出后整组作废直到下一个 IDR（回放缺帧的 GOP 会花屏）
+     */
+    explicit GopCache(size_t max_frames);
+
+    /**
+     * 缓存一帧：IDR 开启新的一组，P 帧追加到当前组，尚未收到 IDR 时丢弃
+     */
+    void push(const EncodedPacketPtr& packet);
+
+    void clear();
+
+    bool empty() const {
+        return _packets.empty();
+    }
+
+    const std::vector<EncodedPacketPtr>& packets() const {
+        return _packets;
+    }
+
+private:
+    const size_t _max_frames;
+    std::vector<EncodedPacketPtr> _packets;
+};
+
+#endif //GB28181CONSOLE_GOP_CACHE_HPP
@@ -3,27 +3,20 @@
 //
 
 #include "header_builder.hpp"
-#include "base_config.hpp"
-#include "utils.hpp"
 
-#include <iostream>
-
-std::vector<uint8_t> HeaderBuilder::buildPesHeader(const uint8_t stream_id, const size_t len, const uint64_t pts_90k) {
-    // 前 6 字节（起始码 + stream_id + length）总是存在
-    std::vector<uint8_t> pes_header(14); // 一般14字节即可满足需求，如果有私有字段，这个长度也需要变
+#include <cstring>
 
+namespace {
+/**
+ * PES 头模板，逐帧只改写 stream_id、长度和 PTS
+ */
+constexpr uint8_t PES_HEADER_TEMPLATE[HeaderBuilder::PES_HEADER_SIZE] = {
     // PES start code【3字节】
-    pes_header[0] = 0x00;
-    pes_header[1] = 0x00;
-    pes_header[2] = 0x01;
-
-    // 流ID【1字节】
-    pes_header[3] = stream_id;
-
-    // PES 长度【2字节】，PES头之后的数据长度（即负载长度 + 可选头长度）
-    const uint16_t pes_len = pes_header.size() - 6 + len;
-    pes_header[4] = (pes_len >> 8) & 0xFF;
-    pes_header[5] = pes_len & 0xFF;
+    0x00, 0x00, 0x01,
+    // 流ID【1字节】，逐帧改写
+    0x00,
+    // PES 长度【2字节】，PES头之后的数据长度（即负载长度 + 可选头长度），逐帧改写
+    0x00, 0x00,
 
     // ================================ 下面的全是可选字段 ================================//
     /**
@@ -38,7 +31,7 @@ std::vector<uint8_t> HeaderBuilder::buildPesHeader(const uint8_t stream_id, cons
      * - 位0: 0 → 是拷贝（首次封装，源头生成位0=1，否则位0=0）
      * */
     // 1000 0111 -> 0x87: MPEG-2 + 未加扰 + 数据对齐 + 有版权 + 原始流
-    pes_header[6] = 0x87;
+    0x87,
 
     /**
      * PES 包第二标志【1字节】，需要按二进制位拆解各位的含义
@@ -53,128 +46,80 @@ std::vector<uint8_t> HeaderBuilder::buildPesHeader(const uint8_t stream_id, cons
      * - 位0: 0 → 扩展字段（私有扩展，基本不用）
      * */
     // 1000 0000 -> 0x80
-    pes_header[7] = 0x80;
+    0x80,
 
     // PES头的附加信息，从第10个字节开始（不包括前9个字节和自己），往后数多少个字节
-    pes_header[8] = 0x05;
+    0x05,
+
+    // PTS【5字节】，所以附加信息长度就是5，逐帧改写
+    0x21, 0x00, 0x01, 0x00, 0x01
+};
+
+/**
+ * 同一帧后续 PES 的头部模板：不带 PTS，也不置数据对齐位
+ */
+constexpr uint8_t PES_CONTINUATION_HEADER_TEMPLATE[HeaderBuilder::PES_CONTINUATION_HEADER_SIZE] = {
+    0x00, 0x00, 0x01,
+    0x00,       // 流ID，逐帧改写
+    0x00, 0x00, // PES 长度，逐帧改写
+    0x83,       // 1000 0011 -> 0x83: MPEG-2 + 未加扰 + 无数据对齐 + 有版权 + 原始流
+    0x00,       // 无 PTS/DTS
+    0x00        // 附加信息长度为 0
+};
+
+/**
+ * PS 头模板，逐帧只改写 SCR
+ */
+constexpr uint8_t PS_PACK_HEADER_TEMPLATE[HeaderBuilder::PS_PACK_HEADER_SIZE] = {
+    // 起始码【4字节】
+    0x00, 0x00, 0x01, 0xBA,
+    // SCR【6字节】，逐帧改写
+    0x44, 0x00, 0x04, 0x00, 0x04, 0x01,
+    // 码流率，直接用最大值模板，提高兼容性
+    0xFF, 0xFF, 0xFC,
+    // 保留位 + 填充长度 0
+    0x00
+};
+
+inline void writeLength(uint8_t* dst, const uint16_t len) {
+    dst[0] = (len >> 8) & 0xFF;
+    dst[1] = len & 0xFF;
+}
+} // namespace
+
+size_t HeaderBuilder::writePesHeader(uint8_t* dst, const uint8_t stream_id, const size_t len, const uint64_t pts_90k) {
+    uint8_t* pes_header = dst;
+    memcpy(pes_header, PES_HEADER_TEMPLATE, PES_HEADER_SIZE);
+
+    pes_header[3] = stream_id;
+    writeLength(pes_header + 4, static_cast<uint16_t>(PES_HEADER_SIZE - 6 + len));
 
-    // PTS【5字节】，所以附加信息长度就是5。MPEG-2 PTS 只有 33 位，必须 mask 掉高位，避免溢出
+    // MPEG-2 PTS 只有 33 位，必须 mask 掉高位，避免溢出
     /**
      * 00000000 00000000 00000000 00000000 00000000
      * [0010][32..30][1][29..15][1][14..0][1]
      */
     const auto pts = pts_90k & 0x1FFFFFFFFULL;
-    pes_header[9] = 0x20 | ((pts >> 30) & 0x07) << 1; // 获取第32-29位, 注意要左移一位加上marker_bit逻辑
-    pes_header[9] |= 0x20;                            // 加上marker_bit
-
-    pes_header[10] = (pts >> 22) & 0xFF; // 获取第28-21位
-    pes_header[10] |= 0x01 << 7;         // 加上marker_bit
-
-    pes_header[11] = (pts >> 14) & 0xFE; // 获取第20-14位, 注意第一位之后需要加marker_bit
-    pes_header[11] |= 0x01;              // 加上marker_bit
-
-    pes_header[12] = (pts >> 7) & 0xFF; // 获取第13-7位
-    pes_header[12] |= 0x01 << 7;        // 加上marker_bit
-
-    pes_header[13] = (pts & 0xFE) | 0x01; // 获取第6-0位, 并在最后加上marker_bit
-    return pes_header;
+    pes_header[9] = 0x20 | ((pts >> 29) & 0x0E) | 0x01; // '0010' + 第32-30位 + marker_bit
+    pes_header[10] = (pts >> 22) & 0xFF;                // 第29-22位
+    pes_header[11] = ((pts >> 14) & 0xFE) | 0x01;       // 第21-15位 + marker_bit
+    pes_header[12] = (pts >> 7) & 0xFF;                 // 第14-7位
+    pes_header[13] = ((pts << 1) & 0xFE) | 0x01;        // 第6-0位 + marker_bit
+    return PES_HEADER_SIZE;
 }
 
-std::vector<uint8_t> HeaderBuilder::buildSystemHeader(const uint8_t video_stream_id,
-                                                      const uint8_t audio_stream_id) {
-    static const uint8_t system_header[] = {
-        0x00, 0x00, 0x01,       // 起始码，固定值
-        0xBB,                   // PS流ID，固定值
-        0x00, 0x10,             // 00 10：'系统头'后续长度=16字节
-        0x80,                   // 1000 0000，系统头标志，第1位marker_bit=1，按规范固定
-        0x04, 0xFF, 0xFF,       // 最大码率（0x04FFFF），主流GB推流模板，单位50字节/秒
-        0xE0, 0x07, 0xC0, 0x0F, // 预留字段
-        video_stream_id,        // 视频stream_id（0xE0-0xEF）
-        0x20, 0x00,             // 视频buffer bound（0x2000，约1MB）
-        audio_stream_id,        // 音频stream_id（0xC0-0xDF）
-        0x01, 0x00              // 音频buffer bound（0x0100，约32KB）
-    };
-    return {system_header, system_header + sizeof(system_header)};
-}
+size_t HeaderBuilder::writePesContinuationHeader(uint8_t* dst, const uint8_t stream_id, const size_t len) {
+    uint8_t* pes_header = dst;
+    memcpy(pes_header, PES_CONTINUATION_HEADER_TEMPLATE, PES_CONTINUATION_HEADER_SIZE);
 
-std::vector<uint8_t> HeaderBuilder::buildPsMap(const uint8_t video_stream_type, const uint8_t video_stream_id,
-                                               const uint8_t audio_stream_type, const uint8_t audio_stream_id) {
-    std::vector<uint8_t> psm;
-
-    // 起始码和 PS Map ID
-    psm.push_back(0x00);
-    psm.push_back(0x00);
-    psm.push_back(0x01);
-    psm.push_back(0xBC);
-
-    // PSM 长度占位符 (稍后填充)
-    const size_t length_pos = psm.size();
-    psm.push_back(0x00);
-    psm.push_back(0x00);
-
-    // 当前有效标志、版本号、保留位
-    psm.push_back(0xE1); // 当前有效(1) + 版本1(00001) + 保留(11)
-    psm.push_back(0xFF); // 保留(1111111) + 标记位(1)
-
-    // Program Stream Info Length
-    psm.push_back(0x00);
-    psm.push_back(0x00);
-
-    // 记录 ES Map 长度字段位置
-    const size_t es_map_length_pos = psm.size();
-    psm.push_back(0x00);
-    psm.push_back(0x00);
-
-    // 记录 ES Map 起始位置（用于计算实际长度）
-    const size_t es_map_start = psm.size();
-
-    // 视频流信息
-    psm.push_back(video_stream_type);
-    psm.push_back(video_stream_id);
-    psm.push_back(0x00); // ES Info Length (高字节)
-    psm.push_back(0x00); // ES Info Length (低字节)
-
-    // 音频流信息
-    psm.push_back(audio_stream_type);
-    psm.push_back(audio_stream_id);
-    psm.push_back(0x00); // ES Info Length (高字节)
-    psm.push_back(0x00); // ES Info Length (低字节)
-
-    // 回填 Elementary Stream Map Length
-    const uint16_t es_map_length = psm.size() - es_map_start;
-    psm[es_map_length_pos] = (es_map_length >> 8) & 0xFF;
-    psm[es_map_length_pos + 1] = es_map_length & 0xFF;
-
-    // CRC32 占位符
-    const size_t crc_pos = psm.size();
-    psm.push_back(0x00);
-    psm.push_back(0x00);
-    psm.push_back(0x00);
-    psm.push_back(0x00);
-
-    // 计算并填充 PSM 长度 (从长度字段之后到PSM结束的字节数)
-    const uint16_t psm_length = psm.size() - length_pos - 2;
-    psm[length_pos] = (psm_length >> 8) & 0xFF;
-    psm[length_pos + 1] = psm_length & 0xFF;
-
-    // CRC32校验【4字节】(从 PS Map ID 之后到 CRC 之前的所有字节)
-    const uint32_t crc = Utils::get()->calculateCRC32(psm, 4, crc_pos - 4);
-    psm[crc_pos] = (crc >> 24) & 0xFF;
-    psm[crc_pos + 1] = (crc >> 16) & 0xFF;
-    psm[crc_pos + 2] = (crc >> 8) & 0xFF;
-    psm[crc_pos + 3] = crc & 0xFF;
-
-    return psm;
+    pes_header[3] = stream_id;
+    writeLength(pes_header + 4, static_cast<uint16_t>(PES_CONTINUATION_HEADER_SIZE - 6 + len));
+    return PES_CONTINUATION_HEADER_SIZE;
 }
 
-std::vector<uint8_t> HeaderBuilder::buildPsPackHeader(uint64_t pts_90k) {
-    std::vector<uint8_t> ps_header(14);
-
-    // 起始码【4字节】
-    ps_header[0] = 0x00;
-    ps_header[1] = 0x00;
-    ps_header[2] = 0x01;
-    ps_header[3] = 0xBA;
+size_t HeaderBuilder::writePsPackHeader(uint8_t* dst, const uint64_t pts_90k) {
+    uint8_t* ps_header = dst;
+    memcpy(ps_header, PS_PACK_HEADER_TEMPLATE, PS_PACK_HEADER_SIZE);
 
     // SCR【6字节 = 48位】——33位数据，其他位是标志位，90kHz时钟
     const auto scr = pts_90k & 0x1FFFFFFFFULL; // 强制保留低 33 位
@@ -204,11 +149,5 @@ std::vector<uint8_t> HeaderBuilder::buildPsPackHeader(uint64_t pts_90k) {
     // byte[9]: scr_ext[6:0] + '1'
     ps_header[9] = ((scr_ext << 1) & 0xFE) // scr_ext[6:0] 移到 bit[7:1]
             | 0x01;                        // marker_bit = 1 在 bit[0]
-
-    // 码流率，直接用最大值模板，提高兼容性
-    ps_header[10] = 0xFF;
-    ps_header[11] = 0xFF;
-    ps_header[12] = 0xFC;
-    ps_header[13] = 0x00;
-    return ps_header;
+    return PS_PACK_HEADER_SIZE;
 }
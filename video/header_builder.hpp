@@ -5,25 +5,129 @@
 #ifndef GB28181CONSOLE_HEADER_BUILDER_HPP
 #define GB28181CONSOLE_HEADER_BUILDER_HPP
 
+#include <cstddef>
 #include <cstdint>
-#include <vector>
 
+#include "utils.hpp"
+
+/**
+ * PS/PES 头部生成
+ *
+ * 逐帧变化的头部（PS 头、PES 头）由固定模板拷贝到调用方提供的缓冲区（通常在栈上），只改写 SCR/PTS/长度字段，
+ * 返回写入的字节数，不做堆分配；系统头和 PSM 在编译期生成
+ * */
 class HeaderBuilder {
 public:
-    static std::vector<uint8_t> buildPesHeader(uint8_t stream_id, size_t len, uint64_t pts_90k);
+    static constexpr size_t PS_PACK_HEADER_SIZE = 14;
+    static constexpr size_t PES_HEADER_SIZE = 14;
+    static constexpr size_t PES_CONTINUATION_HEADER_SIZE = 9;
+
+    /**
+     * @param dst 至少 PES_HEADER_SIZE 字节
+     */
+    static size_t writePesHeader(uint8_t* dst, uint8_t stream_id, size_t len, uint64_t pts_90k);
 
     /**
-     * 只要不加路数、不特殊缓冲策略，系统头就是固定值
-     * */
-    static std::vector<uint8_t> buildSystemHeader(uint8_t video_stream_id, uint8_t audio_stream_id);
+     * 同一帧超过 PES 长度上限时，后续 PES 的头部：不带 PTS，也不置数据对齐位，解复用时与前一个 PES 拼成同一帧
+     *
+     * @param dst 至少 PES_CONTINUATION_HEADER_SIZE 字节
+     */
+    static size_t writePesContinuationHeader(uint8_t* dst, uint8_t stream_id, size_t len);
 
     /**
-     * PSM除了CRC-32之外的其他各个字节在内容（流类型、ID、长度、头部）确定的情况下，都是固定不变的
+     * IDR 帧 PS 头之后的配置头：系统头 + PSM
+     *
+     * 只要流类型、ID 不变，每个字节（含 PSM 的 CRC-32）都是固定的，用 makePsConfig() 在编译期生成
      */
-    static std::vector<uint8_t> buildPsMap(uint8_t video_stream_type, uint8_t video_stream_id,
+    struct PsConfig {
+        static constexpr size_t SYSTEM_HEADER_SIZE = 20;
+        static constexpr size_t PS_MAP_SIZE = 24;
+        static constexpr size_t SIZE = SYSTEM_HEADER_SIZE + PS_MAP_SIZE;
+
+        uint8_t data[SIZE];
+    };
+
+    static constexpr PsConfig makePsConfig(uint8_t video_stream_type, uint8_t video_stream_id,
                                            uint8_t audio_stream_type, uint8_t audio_stream_id);
 
-    static std::vector<uint8_t> buildPsPackHeader(uint64_t pts_90k);
+    /**
+     * @param dst 至少 PS_PACK_HEADER_SIZE 字节
+     */
+    static size_t writePsPackHeader(uint8_t* dst, uint64_t pts_90k);
 };
 
+constexpr HeaderBuilder::PsConfig HeaderBuilder::makePsConfig(const uint8_t video_stream_type,
+                                                              const uint8_t video_stream_id,
+                                                              const uint8_t audio_stream_type,
+                                                              const uint8_t audio_stream_id) {
+    PsConfig config{};
+    uint8_t* p = config.data;
+
+    // ================================ 系统头 ================================//
+    // 只要不加路数、不特殊缓冲策略，系统头就是固定值
+    const uint8_t system_header[PsConfig::SYSTEM_HEADER_SIZE] = {
+        0x00, 0x00, 0x01,       // 起始码，固定值
+        0xBB,                   // PS流ID，固定值
+        0x00, 0x10,             // 00 10：'系统头'后续长度=16字节
+        0x80,                   // 1000 0000，系统头标志，第1位marker_bit=1，按规范固定
+        0x04, 0xFF, 0xFF,       // 最大码率（0x04FFFF），主流GB推流模板，单位50字节/秒
+        0xE0, 0x07, 0xC0, 0x0F, // 预留字段
+        video_stream_id,        // 视频stream_id（0xE0-0xEF）
+        0x20, 0x00,             // 视频buffer bound（0x2000，约1MB）
+        audio_stream_id,        // 音频stream_id（0xC0-0xDF）
+        0x01, 0x00              // 音频buffer bound（0x0100，约32KB）
+    };
+    for (size_t i = 0; i < PsConfig::SYSTEM_HEADER_SIZE; ++i) {
+        p[i] = system_header[i];
+    }
+
+    // ================================ PSM ================================//
+    uint8_t* psm = p + PsConfig::SYSTEM_HEADER_SIZE;
+    constexpr size_t es_map_length = 8; // 视频 + 音频，各 4 字节
+    constexpr size_t crc_pos = PsConfig::PS_MAP_SIZE - 4;
+
+    // 起始码和 PS Map ID
+    psm[0] = 0x00;
+    psm[1] = 0x00;
+    psm[2] = 0x01;
+    psm[3] = 0xBC;
+
+    // PSM 长度 (从长度字段之后到PSM结束的字节数)
+    psm[4] = 0x00;
+    psm[5] = PsConfig::PS_MAP_SIZE - 6;
+
+    // 当前有效标志、版本号、保留位
+    psm[6] = 0xE1; // 当前有效(1) + 版本1(00001) + 保留(11)
+    psm[7] = 0xFF; // 保留(1111111) + 标记位(1)
+
+    // Program Stream Info Length
+    psm[8] = 0x00;
+    psm[9] = 0x00;
+
+    // Elementary Stream Map Length
+    psm[10] = 0x00;
+    psm[11] = es_map_length;
+
+    // 视频流信息
+    psm[12] = video_stream_type;
+    psm[13] = video_stream_id;
+    psm[14] = 0x00; // ES Info Length (高字节)
+    psm[15] = 0x00; // ES Info Length (低字节)
+
+    // 音频流信息
+    psm[16] = audio_stream_type;
+    psm[17] = audio_stream_id;
+    psm[18] = 0x00; // ES Info Length (高字节)
+    psm[19] = 0x00; // ES Info Length (低字节)
+
+    // CRC32校验【4字节】(从 PS Map ID 之后到 CRC 之前的所有字节)
+    const uint32_t crc = Utils::calculateCRC32Bitwise(psm + 4, crc_pos - 4);
+    psm[crc_pos] = (crc >> 24) & 0xFF;
+    psm[crc_pos + 1] = (crc >> 16) & 0xFF;
+    psm[crc_pos + 2] = (crc >> 8) & 0xFF;
+    psm[crc_pos + 3] = crc & 0xFF;
+
+    return config;
+}
+
 #endif //GB28181CONSOLE_HEADER_BUILDER_HPP
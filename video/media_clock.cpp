@@ -0,0 +1,53 @@
+//
+// Created by pengx on 2026/10/16.
+//
+
+#include "media_clock.hpp"
+
+#include <cmath>
+
+MediaClock::MediaClock(const int nominal_fps) : _nominal_interval_us(1000000.0 / nominal_fps) {}
+
+uint64_t MediaClock::toPts90k(const int64_t capture_us) {
+    if (!_has_base) {
+        _has_base = true;
+        _base_us = capture_us;
+        _last_capture_us = capture_us;
+        _last_pts_90k = 0;
+        _stats.frames = 1;
+        return 0;
+    }
+
+    // 帧间隔偏差，用于抖动统计
+    const auto interval_us = static_cast<double>(capture_us - _last_capture_us);
+    const double deviation_us = std::fabs(interval_us - _nominal_interval_us);
+    _jitter_us += (deviation_us - _jitter_us) / 16.0;
+    _last_capture_us = capture_us;
+
+    const int64_t elapsed_us = capture_us - _base_us;
+    uint64_t pts_90k = elapsed_us > 0 ? static_cast<uint64_t>(elapsed_us) * CLOCK_RATE / 1000000 : 0;
+    // 时间戳必须单调递增，驱动时间戳回退时兜底
+    if (pts_90k <= _last_pts_90k) {
+        pts_90k = _last_pts_90k + 1;
+    }
+    _last_pts_90k = pts_90k;
+
+    _stats.frames++;
+    _stats.drift_ms = (static_cast<double>(elapsed_us) - static_cast<double>(_stats.frames - 1) * _nominal_interval_us)
+            / 1000.0;
+    _stats.measured_fps = elapsed_us > 0 ? static_cast<double>(_stats.frames - 1) * 1000000.0 / elapsed_us : 0;
+    _stats.jitter_ms = _jitter_us / 1000.0;
+    if (deviation_us / 1000.0 > _stats.max_jitter_ms) {
+        _stats.max_jitter_ms = deviation_us / 1000.0;
+    }
+    return pts_90k;
+}
+
+void MediaClock::reset() {
+    _has_base = false;
+    _base_us = 0;
+    _last_capture_us = 0;
+    _last_pts_90k = 0;
+    _jitter_us = 0;
+    _stats = Stats{};
+}
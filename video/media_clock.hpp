@@ -0,0 +1,56 @@
+//
+// Created by pengx on 2026/10/16.
+//
+
+#ifndef GB28181CONSOLE_MEDIA_CLOCK_HPP
+#define GB28181CONSOLE_MEDIA_CLOCK_HPP
+
+#include <cstdint>
+
+/**
+ * 采集时钟 -> 90kHz 媒体时钟
+ *
+ * 以会话第一帧的采集时间为零点，pts_90k = (capture_us - base_us) * 90 / 1000，
+ * 保证单调递增；同时统计相对标称帧率的漂移和帧间隔抖动，便于平台侧使用浅播放缓冲。
+ * */
+class MediaClock {
+public:
+    static constexpr uint32_t CLOCK_RATE = 90000; // 90kHz
+
+    struct Stats {
+        uint64_t frames = 0;     // 已换算帧数
+        double measured_fps = 0; // 实测帧率
+        double drift_ms = 0;     // 实际经过时间 - 帧数 × 标称间隔（按帧计数推算时间戳会产生的偏差）
+        double jitter_ms = 0;    // 帧间隔抖动（RFC 3550 平滑算法）
+        double max_jitter_ms = 0;// 单帧最大间隔偏差
+    };
+
+    /**
+     * @param nominal_fps 标称帧率，仅用于统计
+     */
+    explicit MediaClock(int nominal_fps);
+
+    /**
+     * 采集时间戳换算为 90kHz 时间戳
+     *
+     * @param capture_us 采集时间戳（微秒，单调时钟）
+     */
+    uint64_t toPts90k(int64_t capture_us);
+
+    void reset();
+
+    Stats stats() const {
+        return _stats;
+    }
+
+private:
+    const double _nominal_interval_us;
+    bool _has_base = false;
+    int64_t _base_us = 0;
+    int64_t _last_capture_us = 0;
+    uint64_t _last_pts_90k = 0;
+    double _jitter_us = 0;
+    Stats _stats{};
+};
+
+#endif //GB28181CONSOLE_MEDIA_CLOCK_HPP
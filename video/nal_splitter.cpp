@@ -0,0 +1,123 @@
+//
+// Created by pengx on 2026/2/11.
+//
+
+#include "nal_splitter.hpp"
+
+#include <cstring>
+
+NalSplitter::NalSplitter() : _logger("NalSplitter") {
+    _logger.i("NalSplitter created");
+}
+
+static NaluKind h264_kind(const int type) {
+    switch (type) {
+        case 1:
+            return NaluKind::SLICE;
+        case 5:
+            return NaluKind::IRAP;
+        case 6:
+            return NaluKind::SEI;
+        case 7:
+            return NaluKind::SPS;
+        case 8:
+            return NaluKind::PPS;
+        default:
+            return NaluKind::OTHER;
+    }
+}
+
+static NaluKind h265_kind(const int type) {
+    if (type <= 9) {
+        return NaluKind::SLICE;
+    }
+    if (type >= 16 && type <= 21) {
+        return NaluKind::IRAP;
+    }
+    switch (type) {
+        case 32:
+            return NaluKind::VPS;
+        case 33:
+            return NaluKind::SPS;
+        case 34:
+            return NaluKind::PPS;
+        case 39:
+        case 40:
+            return NaluKind::SEI;
+        default:
+            return NaluKind::OTHER;
+    }
+}
+
+size_t NalSplitter::split(const uint8_t* frame, const size_t frame_size, const VideoCodec codec,
+                          NALU* nalus, const size_t capacity) const {
+    if (frame == nullptr || frame_size == 0 || nalus == nullptr || capacity == 0) {
+        return 0;
+    }
+
+    size_t count = 0;
+    bool is_overflow = false;
+    // 当前 NALU 净荷起点，SIZE_MAX 表示还没遇到起始码
+    size_t payload_start = SIZE_MAX;
+
+    // 结束当前 NALU（净荷为空时跳过）
+    auto close_nalu = [&](const size_t end) {
+        if (payload_start == SIZE_MAX || end <= payload_start) {
+            return;
+        }
+        if (count == capacity) {
+            is_overflow = true;
+            return;
+        }
+        NALU& nalu = nalus[count++];
+        nalu.data = const_cast<uint8_t*>(frame + payload_start);
+        nalu.size = end - payload_start;
+        if (codec == VideoCodec::H265) {
+            nalu.type = (nalu.data[0] >> 1) & 0x3F;
+            nalu.kind = h265_kind(nalu.type);
+        } else {
+            nalu.type = nalu.data[0] & 0x1F;
+            nalu.kind = h264_kind(nalu.type);
+        }
+    };
+
+    // 起始码至少 3 字节，候选 0x00 只可能出现在 [0, frame_size - 3]
+    size_t i = 0;
+    while (i + 2 < frame_size && !is_overflow) {
+        const auto* zero = static_cast<const uint8_t*>(memchr(frame + i, 0x00, frame_size - 2 - i));
+        if (zero == nullptr) {
+            break;
+        }
+        const size_t pos = zero - frame;
+        if (frame[pos + 1] != 0x00) {
+            // 下一个字节不是 0，起始码最早从 pos + 2 开始
+            i = pos + 2;
+            continue;
+        }
+
+        size_t start_code_length;
+        if (frame[pos + 2] == 0x01) {
+            start_code_length = 3;
+        } else if (frame[pos + 2] == 0x00 && pos + 3 < frame_size && frame[pos + 3] == 0x01) {
+            start_code_length = 4;
+        } else {
+            i = pos + 1;
+            continue;
+        }
+
+        close_nalu(pos);
+        payload_start = pos + start_code_length;
+        i = payload_start;
+    }
+    close_nalu(frame_size);
+
+    if (payload_start == SIZE_MAX) {
+        _logger.e("未找到任何起始码");
+        return 0;
+    }
+    if (is_overflow) {
+        _logger.e("NALU 个数超过上限，丢弃该帧");
+        return 0;
+    }
+    return count;
+}
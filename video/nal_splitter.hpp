@@ -0,0 +1,84 @@
+//
+// Created by pengx on 2026/2/11.
+//
+
+#ifndef GB28181CONSOLE_NAL_SPLITTER_HPP
+#define GB28181CONSOLE_NAL_SPLITTER_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+#include "logger.hpp"
+#include "video_codec.hpp"
+
+/**
+ * 与编码格式无关的 NALU 分类，封装层只关心这几类
+ */
+enum class NaluKind {
+    SLICE, // 非关键帧条带（H.264: 1，H.265: 0~9）
+    IRAP,  // 随机接入条带（H.264: 5 IDR，H.265: 16~21 BLA/IDR/CRA）
+    VPS,   // 视频参数集（仅 H.265: 32）
+    SPS,   // 序列参数集（H.264: 7，H.265: 33）
+    PPS,   // 图像参数集（H.264: 8，H.265: 34）
+    SEI,   // 补充增强信息（H.264: 6，H.265: 39/40）
+    OTHER  // AUD 等其他类型
+};
+
+/**
+ * @brief NALU 结构体，用于存储单个 NALU 数据
+ */
+struct NALU {
+    uint8_t* data; // NALU 净荷指针（不包含起始码）
+    size_t size;   // NALU 净荷大小
+    int type;      // 原始 NALU 类型（H.264: data[0] & 0x1F，H.265: (data[0] >> 1) & 0x3F）
+    NaluKind kind; // 分类
+};
+
+/**
+ * Annex B 码流（H.264 / H.265）按起始码切分为 NALU
+ * */
+class NalSplitter {
+public:
+    explicit NalSplitter();
+
+    static NalSplitter *get() {
+        static NalSplitter instance;
+        return &instance;
+    }
+
+    NalSplitter(const NalSplitter &) = delete;
+
+    NalSplitter &operator=(const NalSplitter &) = delete;
+
+    /**
+     * 单帧码流上限（字节）：PS 封装一帧最多 MAX_PES_PER_FRAME 个满载 PES（约 2MB），更大的帧本就无法发送
+     */
+    static constexpr size_t MAX_FRAME_BYTES = 2000 * 1000;
+
+    /**
+     * 单帧最多 NALU 个数：按 MTU 切条带（约 1.3KB）时 MAX_FRAME_BYTES 大小的 IDR 约 1500 个条带，再留参数集/SEI 的余量；
+     * 超出时整帧丢弃，FrameEncoder 用 static_assert 保证条带大小下限与之匹配
+     */
+    static constexpr size_t MAX_NALU_PER_FRAME = 2048;
+
+    /**
+     * @brief 分割一帧码流为多个 NALU
+     *
+     * 用 memchr（libc 内部为 SIMD 实现）跳到候选 0x00 字节，只在这些位置校验起始码；
+     * NALU 描述写入调用方提供的定长数组，不做任何堆分配。
+     *
+     * @param frame 码流数据指针
+     * @param frame_size 帧数据大小
+     * @param codec 编码格式，决定 NALU 头的解析方式
+     * @param nalus 输出参数，调用方持有的 NALU 描述数组（指向 frame 内部，不拷贝）
+     * @param capacity nalus 容量，建议 MAX_NALU_PER_FRAME
+     * @return 分割出的 NALU 数量，未找到起始码或超出容量时返回 0
+     */
+    size_t split(const uint8_t *frame, size_t frame_size, VideoCodec codec, NALU *nalus, size_t capacity) const;
+
+private:
+    Logger _logger;
+};
+
+
+#endif //GB28181CONSOLE_NAL_SPLITTER_HPP
@@ -4,16 +4,21 @@
 
 #include "ps_muxer.hpp"
 
+#include <chrono>
+#include <sys/uio.h>
 #include <cstring>
 #include <string>
 
-#include "h264_splitter.hpp"
+#include "copy_stats.hpp"
+#include "nal_splitter.hpp"
 #include "header_builder.hpp"
 #include "rtp_sender.hpp"
 #include "utils.hpp"
+#include "base_config.hpp"
 #include "audio/audio_processor.hpp"
 
 #define STREAM_TYPE_H264 0x1B // 视频Stream Type
+#define STREAM_TYPE_H265 0x24 // 视频Stream Type
 #define STREAM_TYPE_SVAC_VIDEO 0x80 // 视频Stream Type
 
 #define STREAM_TYPE_G711 0x91 // 音频Stream Type
@@ -22,111 +27,79 @@
 #define VIDEO_STREAM_ID 0xE0 // 视频Stream ID
 #define AUDIO_STREAM_ID 0xBD // 音频Stream ID（私有流，常用于非 MPEG 音频，如 AC-3、DTS、G.711）
 
-// GB28181 标准：每个 PS 包的最大大小（考虑 MTU 1500，减去 IP/UDP/RTP 头部）
-// PS包 = PS Header(14) + System Header(~18) + PSM(~24) + PES Header(~19) + Payload
-// 为了确保不超过 MTU，PES 负载应控制在 1300 字节以内
-static constexpr size_t MAX_PES_PAYLOAD_PER_PACKET = 1300;
+// PES_packet_length 只有 16 位，单个 PES 的负载上限 = 65535 - 可选头（标志 3 字节 + PTS 5 字节）
+// 一帧放进一个 PS 包，超过上限时在同一个 PS 包内按 NALU 边界拆成多个 PES，再由 RTP 层按 MTU 分片
+static constexpr size_t MAX_PES_PAYLOAD = 0xFFFF - 8;
+// 单帧 PES 个数上限（约 2MB），PES 头都放在发送帧的头部缓冲区中
+static constexpr size_t MAX_PES_PER_FRAME = 32;
+static_assert(MAX_PES_PER_FRAME * MAX_PES_PAYLOAD >= NalSplitter::MAX_FRAME_BYTES,
+              "NalSplitter::MAX_FRAME_BYTES exceeds what one PS pack can carry");
+static_assert(HeaderBuilder::PS_PACK_HEADER_SIZE + MAX_PES_PER_FRAME * HeaderBuilder::PES_HEADER_SIZE <=
+              RtpSender::Frame::HEADER_CAPACITY, "PS/PES headers exceed RtpSender::Frame::HEADER_CAPACITY");
 
-/**
- * 封装 PS 包，其实就是把 PES 包转为 PS 包，通俗来说就是将音视频同一化，方便后续封装为PS流
- *
- * PS 包 = [起始码] + [PS Header] + [System Header(仅IDR帧)] + [PSM(仅IDR帧)] + [PES 包]
- *
- * @param payload PES 包数据
- * @param len PES 包大小
- * @param pts_90k 时间戳（90kHz）
- * @param is_key_frame 是否为关键帧
- * */
-static void buildPsPacket(const uint8_t* payload, const size_t len, const uint64_t pts_90k, const bool is_key_frame) {
-    // ================================ 添加PS头 ================================//
-    const auto ps_header = HeaderBuilder::buildPsPackHeader(pts_90k);
-
-    // ================================ 添加系统头和PSM ================================//
-    std::vector<uint8_t> config{};
-    if (is_key_frame) {
-        config = HeaderBuilder::buildSystemHeader(VIDEO_STREAM_ID, AUDIO_STREAM_ID);
-        auto psm = HeaderBuilder::buildPsMap(STREAM_TYPE_H264,VIDEO_STREAM_ID,
-                                             STREAM_TYPE_G711,AUDIO_STREAM_ID);
-        config.insert(config.end(), psm.begin(), psm.end());
-    }
+// IDR 帧的系统头 + PSM（含 CRC）
+static constexpr HeaderBuilder::PsConfig PS_CONFIG_H264 =
+        HeaderBuilder::makePsConfig(STREAM_TYPE_H264, VIDEO_STREAM_ID, STREAM_TYPE_G711, AUDIO_STREAM_ID);
+static constexpr HeaderBuilder::PsConfig PS_CONFIG_H265 =
+        HeaderBuilder::makePsConfig(STREAM_TYPE_H265, VIDEO_STREAM_ID, STREAM_TYPE_G711, AUDIO_STREAM_ID);
 
-    // ================================ 封装 PS 包 ================================//
-    // 计算总大小
-    const size_t total_size = ps_header.size() + config.size() + len;
-    std::vector<uint8_t> ps_pkt(total_size);
+// 时钟统计日志间隔（采集时间，微秒）
+static constexpr int64_t CLOCK_STATS_LOG_INTERVAL_US = 30 * 1000000LL;
 
-    size_t offset = 0;
-    memcpy(ps_pkt.data() + offset, ps_header.data(), ps_header.size());
-    offset += ps_header.size();
+// GOP 缓存上限：一个完整 GOP 再留 1 秒余量
+static constexpr size_t GOP_CACHE_MAX_FRAMES = VIDEO_GOP_SIZE + VIDEO_FPS;
 
-    // 添加 System Header 和 PSM（如果存在）
-    if (!config.empty()) {
-        memcpy(ps_pkt.data() + offset, config.data(), config.size());
-        offset += config.size();
+/**
+ * 条带是否属于非参考帧：H.264 nal_ref_idc == 0；H.265 子层非参考图像（nal_unit_type 为 0~14 的偶数）
+ */
+static bool is_non_reference(const NALU& nalu, const bool is_h265) {
+    if (nalu.size == 0) {
+        return false;
     }
-
-    // 添加 PES 载荷数据
-    memcpy(ps_pkt.data() + offset, payload, len);
-
-    RtpSender::get()->sendDataPacket(ps_pkt.data(), ps_pkt.size(), is_key_frame, pts_90k);
+    if (is_h265) {
+        return nalu.type <= 14 && nalu.type % 2 == 0;
+    }
+    return (nalu.data[0] & 0x60) == 0;
 }
 
 /**
- * 封装 PES 包，其实就是把 整帧的 NALU 或者 G.711μ 数据转为 PES 包，通俗来说就是将音视频同一化，方便后续封装为PS流
+ * 负载拆分为多个 PES：每个 PES 尽量在 NALU 边界结束，条带不会被续包的 PES 头截断；
+ * 单个 NALU 超过 MAX_PES_PAYLOAD 时才在 NALU 内部拆分
  *
- * PES包 = [起始码] + [PES Header] + [负载数据]
- *
- * @param stream_id 流ID
- * @param payload 负载数据（没有起始码）
- * @param len 负载大小
- * @param pts_90k 时间戳（90kHz）
- * @param is_key_frame 是否为关键帧
- * */
-static void buildPesPacket(const uint8_t stream_id, const uint8_t* payload, size_t len, const uint64_t pts_90k,
-                           const bool is_key_frame) {
-    // 如果负载小于阈值，直接封装成一个 PS 包
-    if (len <= MAX_PES_PAYLOAD_PER_PACKET) {
-        std::vector<uint8_t> pes_header = HeaderBuilder::buildPesHeader(stream_id, len, pts_90k);
-
-        // 不必管是SPS/PPS/G.711μ/IDR/P，这些都是PES的载荷，载荷位置 = 动态的，由第9字节决定。
-        std::vector<uint8_t> pes_pkt(pes_header.size() + len); // pes_header + 负载数据
-
-        // 添加 PES header
-        std::copy(pes_header.begin(), pes_header.end(), pes_pkt.begin());
-
-        // 添加载荷数据
-        std::memcpy(pes_pkt.data() + pes_header.size(), payload, len);
-
-        // 封装PS包
-        buildPsPacket(pes_pkt.data(), pes_pkt.size(), pts_90k, is_key_frame);
-    } else {
-        size_t remaining = len;
-        size_t offset = 0;
-        int packet_index = 0;
-
-        while (remaining > 0) {
-            size_t chunk_size = (remaining > MAX_PES_PAYLOAD_PER_PACKET) ? MAX_PES_PAYLOAD_PER_PACKET : remaining;
-
-            // 为每个分片构建PES包
-            std::vector<uint8_t> pes_header = HeaderBuilder::buildPesHeader(stream_id, chunk_size, pts_90k);
-            std::vector<uint8_t> pes_pkt(pes_header.size() + chunk_size);
-
-            std::copy(pes_header.begin(), pes_header.end(), pes_pkt.begin());
-            std::memcpy(pes_pkt.data() + pes_header.size(), payload + offset, chunk_size);
-
-            // 只有最后一个包标记 marker bit（关键帧标记）
-            const bool mark_as_key = is_key_frame && (remaining <= MAX_PES_PAYLOAD_PER_PACKET);
-
-            buildPsPacket(pes_pkt.data(), pes_pkt.size(), pts_90k, mark_as_key);
-
-            offset += chunk_size;
-            remaining -= chunk_size;
-            packet_index++;
+ * @param pes_ends 输出，每个 PES 负载的结束偏移
+ * @return PES 个数，超过 MAX_PES_PER_FRAME 时返回 0
+ */
+static size_t split_pes(const size_t len, const size_t* boundaries, const size_t boundary_count, size_t* pes_ends) {
+    size_t pes_count = 0;
+    size_t offset = 0;
+    size_t boundary_index = 0;
+    while (offset < len) {
+        if (pes_count == MAX_PES_PER_FRAME) {
+            return 0;
         }
+        size_t end = len - offset > MAX_PES_PAYLOAD ? offset + MAX_PES_PAYLOAD : len;
+        if (end < len) {
+            // 不超过上限的最后一个 NALU 边界
+            size_t aligned = offset;
+            while (boundary_index < boundary_count && boundaries[boundary_index] <= end) {
+                aligned = boundaries[boundary_index++];
+            }
+            if (aligned > offset) {
+                end = aligned;
+            }
+        }
+        pes_ends[pes_count++] = end;
+        offset = end;
     }
+    return pes_count;
+}
+
+static int64_t steady_now_us() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
 }
 
-PsMuxer::PsMuxer() : _logger("PsMuxer") {
+PsMuxer::PsMuxer() : _logger("PsMuxer"), _video_clock(VIDEO_FPS), _gop_cache(GOP_CACHE_MAX_FRAMES) {
     _logger.i("PsMuxer created");
 }
 
@@ -140,35 +113,171 @@ PsMuxer::PsMuxer() : _logger("PsMuxer") {
  * - IDR帧：由一个IDR类型的NALU构成
  * - P帧：由一个或多个P slice类型的NALU构成
  * */
-void PsMuxer::writeVideoFrame(const uint8_t* h264_data, const uint64_t pts_90k, const size_t size) {
+void PsMuxer::writeVideoFrame(const EncodedPacketPtr& packet) {
+    if (!packet) {
+        return;
+    }
+
     std::lock_guard<std::mutex> lock(_muxer_mutex);
 
-    std::vector<NALU> nalu_vector{};
-    const size_t nalu_count = H264Splitter::get()->splitH264Frame(h264_data, size, nalu_vector);
+    // 会话期间也跟踪当前 GOP，会话结束后（GOP_CACHE_WHILE_IDLE 时编码器不停）下一次 INVITE 可以直接回放
+    _gop_cache.push(packet);
+    // 空闲或 INVITE 处理中：只缓存，不发送
+    if (!_is_session_started) {
+        return;
+    }
+    mux_video_frame(packet, packet->captureUs());
+}
+
+bool PsMuxer::prepareSession(const VideoCodec codec, const bool keep_gop_cache) {
+    std::lock_guard<std::mutex> lock(_muxer_mutex);
+
+    _vps_cache.clear();
+    _sps_cache.clear();
+    _pps_cache.clear();
+    _is_waiting_for_idr = true;
+    _is_idr_sent = false;
+    _video_clock.reset();
+    _last_stats_log_us = 0;
+    if (!keep_gop_cache || (!_gop_cache.empty() && _gop_cache.packets().front()->codec() != codec)) {
+        _gop_cache.clear();
+    }
+    _is_session_started = false;
+    _invite_us = steady_now_us();
+    return !_gop_cache.empty();
+}
+
+bool PsMuxer::startSession() {
+    std::lock_guard<std::mutex> lock(_muxer_mutex);
+
+    _is_session_started = true;
+    // 回放与后续实时帧都在同一把锁下，顺序不会交错
+    return replay_gop_cache();
+}
+
+bool PsMuxer::replay_gop_cache() {
+    if (_gop_cache.empty()) {
+        _logger.i("GOP cache empty, waiting for next IDR frame");
+        return false;
+    }
+    const auto& packets = _gop_cache.packets();
+    const int64_t newest_us = packets.back()->captureUs();
+    const int64_t span_us = newest_us - packets.front()->captureUs();
+    _is_replaying = true;
+    if (span_us <= GOP_REPLAY_MAX_MS * 1000LL) {
+        _logger.iFmt("Replaying cached GOP: %zu frames, %.1f ms", packets.size(), static_cast<double>(span_us) / 1000.0);
+        for (const auto& packet : packets) {
+            mux_video_frame(packet, packet->captureUs());
+        }
+        _is_replaying = false;
+        return false;
+    }
+
+    // 缓存跨度过长：只发 IDR（自带参数集）让平台立即出画面，时间戳取最新一帧的采集时刻，
+    // 之后的实时帧时间戳继续递增；实时 P 帧参考的是未发送的帧，丢弃到编码器按请求输出的下一个 IDR
+    _logger.iFmt("Cached GOP spans %.1f ms (%zu frames), replaying its IDR only", static_cast<double>(span_us) / 1000.0,
+                 packets.size());
+    mux_video_frame(packets.front(), newest_us);
+    _is_replaying = false;
+    _is_waiting_for_idr = true;
+    return true;
+}
+
+void PsMuxer::on_first_decodable_packet(const int64_t capture_us) {
+    if (_invite_us == 0) {
+        return;
+    }
+    const int64_t now_us = steady_now_us();
+    const double elapsed_ms = static_cast<double>(now_us - _invite_us) / 1000.0;
+    // 采集时间戳与 steady_clock 同为 CLOCK_MONOTONIC
+    const double lag_ms = static_cast<double>(now_us - capture_us) / 1000.0;
+    _invite_us = 0;
+
+    auto& stats = _session_stats;
+    ++stats.sessions;
+    if (_is_replaying) {
+        ++stats.replayed;
+    }
+    stats.last_ms = elapsed_ms;
+    stats.avg_ms += (elapsed_ms - stats.avg_ms) / static_cast<double>(stats.sessions);
+    if (elapsed_ms > stats.max_ms) {
+        stats.max_ms = elapsed_ms;
+    }
+    stats.last_lag_ms = lag_ms;
+    stats.avg_lag_ms += (lag_ms - stats.avg_lag_ms) / static_cast<double>(stats.sessions);
+    if (lag_ms > stats.max_lag_ms) {
+        stats.max_lag_ms = lag_ms;
+    }
+    _logger.iFmt("First decodable packet sent %.1f ms after INVITE (%s), avg %.1f ms, max %.1f ms; "
+                 "picture lag %.1f ms, avg %.1f ms, max %.1f ms",
+                 elapsed_ms, _is_replaying ? "GOP cache" : "live IDR", stats.avg_ms, stats.max_ms, lag_ms,
+                 stats.avg_lag_ms, stats.max_lag_ms);
+}
+
+void PsMuxer::mux_video_frame(const EncodedPacketPtr& packet, const int64_t capture_us) {
+    const uint8_t* frame_data = packet->data();
+    const size_t size = packet->size();
+
+    // 由采集时钟推导 90kHz 时间戳，帧率波动或丢帧都不会让时间戳偏离真实时间
+    const uint64_t pts_90k = _video_clock.toPts90k(capture_us);
+    if (capture_us - _last_stats_log_us >= CLOCK_STATS_LOG_INTERVAL_US) {
+        const auto stats = _video_clock.stats();
+        _logger.dBox()
+               .add("视频时钟统计")
+               .addFmt("帧数: %llu", static_cast<unsigned long long>(stats.frames))
+               .addFmt("实测帧率: %.2f", stats.measured_fps)
+               .addFmt("累计漂移: %.1f ms", stats.drift_ms)
+               .addFmt("帧间隔抖动: %.2f ms（最大 %.2f ms）", stats.jitter_ms, stats.max_jitter_ms)
+               .print();
+        log_copy_stats();
+        _last_stats_log_us = capture_us;
+    }
+
+    const VideoCodec codec = packet->codec();
+    const bool is_h265 = codec == VideoCodec::H265;
+    _video_stream_type = is_h265 ? STREAM_TYPE_H265 : STREAM_TYPE_H264;
+
+    NALU nalus[NalSplitter::MAX_NALU_PER_FRAME];
+    const size_t nalu_count = NalSplitter::get()->split(frame_data, size, codec, nalus,
+                                                        NalSplitter::MAX_NALU_PER_FRAME);
     if (nalu_count == 0) {
-        _logger.e("H.264 frame is empty");
+        _logger.eFmt("%s frame is empty", videoCodecName(codec));
         return;
     }
 
-    std::vector<NALU> other_frames{};
-    std::vector<NALU> idr_frames{};
+    // 条带按类型计数，之后直接遍历 nalus 取用，不再逐帧拷贝到临时数组
+    size_t slice_count = 0;
+    size_t idr_count = 0;
+    const NALU* vps_ptr = nullptr;
     const NALU* sps_ptr = nullptr;
     const NALU* pps_ptr = nullptr;
-
-    // 解析NALUs并识别SPS/PPS/IDR
-    for (auto& nalu : nalu_vector) {
+    // 帧内只有需要发送的 NALU 时，重新拼装的 PES 负载与编码输出完全一致，可以直接引用编码输出
+    bool is_forwardable = true;
+    // PES 负载中每个 NALU 起始码的偏移（最多再加上补齐的 VPS/SPS/PPS）
+    size_t boundaries[NalSplitter::MAX_NALU_PER_FRAME + 3];
+    size_t boundary_count = 0;
+
+    // 解析NALUs并识别VPS/SPS/PPS/IDR（H.265 的 IRAP 也按 IDR 处理）
+    for (size_t i = 0; i < nalu_count; ++i) {
+        const NALU& nalu = nalus[i];
         if (!nalu.data)
             continue;
-        switch (nalu.type) {
-            case 1: // 非IDR帧（P帧）
-                other_frames.push_back(nalu);
+        switch (nalu.kind) {
+            case NaluKind::SLICE: // 非IDR帧（P帧）
+                ++slice_count;
                 break;
-            case 5: // IDR帧
-                idr_frames.push_back(nalu);
+            case NaluKind::IRAP: // IDR帧
+                ++idr_count;
                 break;
-            case 6: // SEI
+            case NaluKind::SEI:
+                is_forwardable = false;
                 break;
-            case 7: // SPS
+            case NaluKind::VPS:
+                vps_ptr = &nalu;
+                _vps_cache.assign(nalu.data, nalu.data + nalu.size);
+                _logger.dFmt("保存VPS，大小=%zu", _vps_cache.size());
+                break;
+            case NaluKind::SPS:
                 sps_ptr = &nalu;
                 _sps_cache.assign(nalu.data, nalu.data + nalu.size);
                 _logger.dBox()
@@ -176,7 +285,7 @@ void PsMuxer::writeVideoFrame(const uint8_t* h264_data, const uint64_t pts_90k,
                        .addFmt("所有字节: %s", Utils::get()->bytesToHex(_sps_cache, _sps_cache.size()).c_str())
                        .print();
                 break;
-            case 8: // PPS
+            case NaluKind::PPS:
                 pps_ptr = &nalu;
                 _pps_cache.assign(nalu.data, nalu.data + nalu.size);
                 _logger.dBox()
@@ -185,13 +294,22 @@ void PsMuxer::writeVideoFrame(const uint8_t* h264_data, const uint64_t pts_90k,
                        .print();
                 break;
             default:
+                is_forwardable = false;
                 break;
         }
     }
 
+    // 所有条带都是非参考条带时，丢弃本帧不影响后续帧解码
+    bool is_droppable = idr_count == 0 && slice_count > 0;
+    for (size_t i = 0; is_droppable && i < nalu_count; ++i) {
+        if (nalus[i].data && nalus[i].kind == NaluKind::SLICE && !is_non_reference(nalus[i], is_h265)) {
+            is_droppable = false;
+        }
+    }
+
     // 等待接收到第一个IDR帧才开始处理
     if (_is_waiting_for_idr) {
-        if (idr_frames.empty()) {
+        if (idr_count == 0) {
             _logger.i("Waiting for first IDR frame, dropping current frame");
             return;
         }
@@ -199,19 +317,50 @@ void PsMuxer::writeVideoFrame(const uint8_t* h264_data, const uint64_t pts_90k,
         _logger.i("First IDR frame received, starting stream");
     }
 
-    // 如果是关键帧，先打包 SPS+PPS+IDR
-    if (!idr_frames.empty()) {
+    // IDR 帧需要自带参数集（x264/x265 默认每个 IDR 前都会重复输出，H.265 还需要 VPS），且不能混有其他条带
+    if (idr_count > 0 && (!sps_ptr || !pps_ptr || (is_h265 && !vps_ptr) || slice_count > 0)) {
+        is_forwardable = false;
+    }
+
+    if (is_forwardable) {
+        // 直接引用编码输出，不重新拼装
+        const bool is_key_frame = idr_count > 0;
+        if (is_key_frame) {
+            _logger.dFmt("处理IDR帧，共 %zu 个（直接引用编码输出，%zu 字节）", idr_count, size);
+        }
+        // 每个 NALU（连同其起始码）的起始偏移，RTP 分片时尽量不让条带跨包
+        for (size_t i = 1; i < nalu_count; ++i) {
+            boundaries[boundary_count++] = nalus[i - 1].data + nalus[i - 1].size - frame_data;
+        }
+        send_ps_packet(VIDEO_STREAM_ID, packet, frame_data, size, pts_90k, is_key_frame, is_droppable, boundaries,
+                       boundary_count);
+        if (is_key_frame) {
+            _is_idr_sent = true;
+            on_first_decodable_packet(packet->captureUs());
+        }
+    } else if (idr_count > 0) {
+        // 如果是关键帧，先打包 [VPS+]SPS+PPS+IDR
         auto box = _logger.dBox();
-        box.addFmt("处理IDR帧，共 %zu 个", idr_frames.size());
+        box.addFmt("处理IDR帧，共 %zu 个", idr_count);
 
         std::vector<uint8_t> pes_payload;
 
-        // 优先使用当前帧的SPS/PPS，否则使用缓存
+        // 优先使用当前帧的参数集，否则使用缓存
+        const uint8_t* vps_data = nullptr;
+        size_t vps_size = 0;
         const uint8_t* sps_data = nullptr;
         size_t sps_size = 0;
         const uint8_t* pps_data = nullptr;
         size_t pps_size = 0;
 
+        if (vps_ptr) {
+            vps_data = vps_ptr->data;
+            vps_size = vps_ptr->size;
+        } else if (!_vps_cache.empty()) {
+            vps_data = _vps_cache.data();
+            vps_size = _vps_cache.size();
+        }
+
         if (sps_ptr) {
             sps_data = sps_ptr->data;
             sps_size = sps_ptr->size;
@@ -228,51 +377,168 @@ void PsMuxer::writeVideoFrame(const uint8_t* h264_data, const uint64_t pts_90k,
             pps_size = _pps_cache.size();
         }
 
-        if (!sps_data || !pps_data) {
-            _logger.e("No SPS/PPS available, dropping IDR frame");
+        if (!sps_data || !pps_data || (is_h265 && !vps_data)) {
+            _logger.e("No parameter sets available, dropping IDR frame");
             return;
         }
 
+        // 添加 VPS（仅 H.265，带起始码）
+        if (is_h265) {
+            boundaries[boundary_count++] = pes_payload.size();
+            pes_payload.insert(pes_payload.end(), {0x00, 0x00, 0x00, 0x01});
+            pes_payload.insert(pes_payload.end(), vps_data, vps_data + vps_size);
+        }
+
         // 添加 SPS（带起始码）
+        boundaries[boundary_count++] = pes_payload.size();
         pes_payload.insert(pes_payload.end(), {0x00, 0x00, 0x00, 0x01});
         pes_payload.insert(pes_payload.end(), sps_data, sps_data + sps_size);
 
         // 添加 PPS（带起始码）
+        boundaries[boundary_count++] = pes_payload.size();
         pes_payload.insert(pes_payload.end(), {0x00, 0x00, 0x00, 0x01});
         pes_payload.insert(pes_payload.end(), pps_data, pps_data + pps_size);
 
         // 添加所有IDR帧（带起始码）
-        for (const auto& idr : idr_frames) {
+        for (size_t i = 0; i < nalu_count; ++i) {
+            const NALU& idr = nalus[i];
+            if (!idr.data || idr.kind != NaluKind::IRAP) {
+                continue;
+            }
+            boundaries[boundary_count++] = pes_payload.size();
             pes_payload.insert(pes_payload.end(), {0x00, 0x00, 0x00, 0x01});
             pes_payload.insert(pes_payload.end(), idr.data, idr.data + idr.size);
         }
 
+        CopyStats::get()->onCopy(CopyStage::PES_PAYLOAD, pes_payload.size());
+
         // 打印最终的PES payload前64字节
         const size_t print_len = pes_payload.size() < 64 ? pes_payload.size() : 64;
         box.addFmt("最终 PES 载荷前%zu字节: ", print_len).add(Utils::get()->bytesToHex(pes_payload, print_len)).print();
 
-        // 封装IDR帧为PES包（标记为关键帧）
-        buildPesPacket(VIDEO_STREAM_ID, pes_payload.data(), pes_payload.size(), pts_90k, true);
+        // 封装IDR帧为PS包（标记为关键帧）
+        const auto payload = std::make_shared<const std::vector<uint8_t>>(std::move(pes_payload));
+        send_ps_packet(VIDEO_STREAM_ID, payload, payload->data(), payload->size(), pts_90k, true, false, boundaries,
+                       boundary_count);
         _is_idr_sent = true;
-    } else if (!other_frames.empty()) {
+        on_first_decodable_packet(packet->captureUs());
+    } else if (slice_count > 0) {
         // 处理非IDR帧（P/B帧）
         std::vector<uint8_t> pes_payload;
 
-        for (const auto& nalu : other_frames) {
+        for (size_t i = 0; i < nalu_count; ++i) {
+            const NALU& nalu = nalus[i];
+            if (!nalu.data || nalu.kind != NaluKind::SLICE) {
+                continue;
+            }
             // 添加起始码 + NALU payload
+            boundaries[boundary_count++] = pes_payload.size();
             pes_payload.insert(pes_payload.end(), {0x00, 0x00, 0x00, 0x01});
             pes_payload.insert(pes_payload.end(), nalu.data, nalu.data + nalu.size);
         }
 
         if (!pes_payload.empty()) {
-            // 封装非关键帧为PES包
-            buildPesPacket(VIDEO_STREAM_ID, pes_payload.data(), pes_payload.size(), pts_90k, false);
+            CopyStats::get()->onCopy(CopyStage::PES_PAYLOAD, pes_payload.size());
+            // 封装非关键帧为PS包
+            const auto payload = std::make_shared<const std::vector<uint8_t>>(std::move(pes_payload));
+            send_ps_packet(VIDEO_STREAM_ID, payload, payload->data(), payload->size(), pts_90k, false, is_droppable,
+                           boundaries, boundary_count);
         }
     } else {
         _logger.w("没有IDR帧也没有P帧");
     }
 }
 
+/**
+ * 把一帧（一个访问单元）封装为一个 PS 包并通过 RTP 发送
+ *
+ * PS 包 = [PS Header] + [System Header(仅IDR帧)] + [PSM(仅IDR帧)] + [PES 包]...
+ * PES 包 = [起始码] + [PES Header] + [负载数据]
+ *
+ * 一帧只有一个 PS 头和一个 PES 头（超过 PES 长度上限时才拆成多个 PES，只有第一个带 PTS），
+ * 按 MTU 分片交给 RTP 层，帧的最后一个 RTP 包置 marker，平台收到即可出帧，不必等下一个时间戳。
+ * 头部写在发送帧自带的缓冲区（循环复用），负载按引用以 iovec 交给 RtpSender，不做任何拷贝。
+ *
+ * @param stream_id 流ID
+ * @param payload_owner 负载所有者，发送完成前保持负载有效
+ * @param payload 负载数据（整帧的 NALU 或者 G.711μ 数据）
+ * @param len 负载大小
+ * @param pts_90k 时间戳（90kHz）
+ * @param is_key_frame 是否为关键帧
+ * @param is_droppable 是否可单独丢弃（非参考帧、音频帧），发送队列溢出时优先丢弃
+ * @param boundaries 负载中 NALU（含起始码）的起始偏移，升序，负载在这些位置拆成独立分段，RTP 分片时尽量不跨包
+ * @param boundary_count 偏移个数
+ * */
+void PsMuxer::send_ps_packet(const uint8_t stream_id, std::shared_ptr<const void> payload_owner,
+                             const uint8_t* payload, const size_t len, const uint64_t pts_90k, const bool is_key_frame,
+                             const bool is_droppable, const size_t* boundaries, const size_t boundary_count) {
+    size_t pes_ends[MAX_PES_PER_FRAME];
+    size_t pes_count = split_pes(len, boundaries, boundary_count, pes_ends);
+    if (pes_count == 0 && boundary_count > 0) {
+        // 按边界对齐的 PES 过多（极端的 NALU 大小分布），退回按上限等长拆分
+        pes_count = split_pes(len, nullptr, 0, pes_ends);
+    }
+    if (pes_count == 0) {
+        _logger.eFmt("Invalid PS payload size: %zu", len);
+        return;
+    }
+
+    auto frame = RtpSender::get()->acquireFrame();
+    frame->timestamp = static_cast<uint32_t>(pts_90k);
+    frame->is_video = stream_id == VIDEO_STREAM_ID;
+    frame->is_key_frame = is_key_frame;
+    frame->is_droppable = is_droppable;
+    frame->is_replayed = _is_replaying;
+    frame->payload_owner = std::move(payload_owner);
+
+    // PS 头 +（系统头和 PSM）+ 每个 PES 的头和负载，负载再按 NALU 边界拆分
+    auto& segments = frame->segments;
+    segments.reserve(2 + pes_count * 2 + boundary_count);
+    uint8_t* headers = frame->headers;
+
+    // ================================ 添加PS头 ================================//
+    const size_t ps_header_size = HeaderBuilder::writePsPackHeader(headers, pts_90k);
+    segments.push_back({headers, ps_header_size});
+    headers += ps_header_size;
+
+    // ================================ 添加系统头和PSM ================================//
+    // 编译期生成，只随视频 stream_type 变化
+    if (is_key_frame) {
+        const auto& config = _video_stream_type == STREAM_TYPE_H265 ? PS_CONFIG_H265 : PS_CONFIG_H264;
+        segments.push_back({const_cast<uint8_t*>(config.data), HeaderBuilder::PsConfig::SIZE});
+    }
+
+    // ================================ 添加 PES 包 ================================//
+    // 不必管是SPS/PPS/G.711μ/IDR/P，这些都是PES的载荷
+    size_t offset = 0;
+    size_t boundary_index = 0;
+    for (size_t i = 0; i < pes_count; ++i) {
+        const size_t chunk_end = pes_ends[i];
+        const size_t chunk_size = chunk_end - offset;
+        const size_t header_size = i == 0
+                                       ? HeaderBuilder::writePesHeader(headers, stream_id, chunk_size, pts_90k)
+                                       : HeaderBuilder::writePesContinuationHeader(headers, stream_id, chunk_size);
+        segments.push_back({headers, header_size});
+        headers += header_size;
+
+        // 本 PES 内的负载按 NALU 边界拆成多个分段
+        while (offset < chunk_end) {
+            while (boundary_index < boundary_count && boundaries[boundary_index] <= offset) {
+                ++boundary_index;
+            }
+            size_t segment_end = chunk_end;
+            if (boundary_index < boundary_count && boundaries[boundary_index] < chunk_end) {
+                segment_end = boundaries[boundary_index];
+            }
+            segments.push_back({const_cast<uint8_t*>(payload + offset), segment_end - offset});
+            offset = segment_end;
+        }
+    }
+
+    // 入队后立即返回，由发送线程发送
+    RtpSender::get()->enqueueFrame(std::move(frame));
+}
+
 void PsMuxer::writeAudioFrame(const uint8_t* pcm_data, const uint64_t pts_90k, const size_t len) {
     if (!_is_idr_sent) {
         return;
@@ -294,17 +560,48 @@ void PsMuxer::writeAudioFrame(const uint8_t* pcm_data, const uint64_t pts_90k, c
     AudioProcessor::pcm_to_ulaw(pcm_buffer.data(), g711_buffer.data(), samples);
     // AudioProcessor::pcm_to_alaw(pcm_buffer.data(), g711_buffer.data(), samples);
 
-    // 封装 PES 包
-    buildPesPacket(AUDIO_STREAM_ID, g711_buffer.data(), g711_buffer.size(), pts_90k, false);
+    // 封装 PS 包
+    const auto payload = std::make_shared<const std::vector<uint8_t>>(std::move(g711_buffer));
+    send_ps_packet(AUDIO_STREAM_ID, payload, payload->data(), payload->size(), pts_90k, false, true);
 }
 
 void PsMuxer::release() {
     std::lock_guard<std::mutex> lock(_muxer_mutex);
 
+    _vps_cache.clear();
     _sps_cache.clear();
     _pps_cache.clear();
     _is_waiting_for_idr = true;
     _is_idr_sent = false;
+    _video_clock.reset();
+    _last_stats_log_us = 0;
+    // 保留当前 GOP，由下一次 prepareSession 决定能否回放
+    _is_session_started = false;
+    _invite_us = 0;
 
     _logger.i("PsMuxer released");
 }
+
+void PsMuxer::log_copy_stats() {
+    const auto stats = CopyStats::get()->snapshot();
+    auto box = _logger.dBox();
+    box.add("码流拷贝统计")
+       .addFmt("帧数: %llu，每帧拷贝 %.2f 次，每字节拷贝 %.2f 次", static_cast<unsigned long long>(stats.frames),
+               stats.copiesPerFrame(), stats.copiesPerByte())
+       .addFmt("按引用发送: %llu 字节", static_cast<unsigned long long>(stats.gather_bytes));
+    for (int i = 0; i < static_cast<int>(CopyStage::COUNT); ++i) {
+        box.addFmt("%s: %llu 次，%llu 字节", CopyStats::stageName(static_cast<CopyStage>(i)),
+                   static_cast<unsigned long long>(stats.copies[i]), static_cast<unsigned long long>(stats.bytes[i]));
+    }
+    box.print();
+}
+
+MediaClock::Stats PsMuxer::getClockStats() {
+    std::lock_guard<std::mutex> lock(_muxer_mutex);
+    return _video_clock.stats();
+}
+
+PsMuxer::SessionStats PsMuxer::getSessionStats() {
+    std::lock_guard<std::mutex> lock(_muxer_mutex);
+    return _session_stats;
+}
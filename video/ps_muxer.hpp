@@ -5,10 +5,14 @@
 #ifndef GB28181CONSOLE_PS_MUXER_HPP
 #define GB28181CONSOLE_PS_MUXER_HPP
 
+#include <memory>
 #include <mutex>
 #include <vector>
 
+#include "encoded_packet.hpp"
+#include "gop_cache.hpp"
 #include "logger.hpp"
+#include "media_clock.hpp"
 
 /**
  * PS 的基本单位包括：
@@ -29,19 +33,103 @@ public:
 
     PsMuxer& operator=(const PsMuxer&) = delete;
 
-    void writeVideoFrame(const uint8_t* h264_data, uint64_t pts_90k, size_t size);
+    /**
+     * 起播统计：耗时（收到 INVITE -> 第一个可解码的 RTP 包发出）与画面滞后（该帧的采集时刻 -> 发出）
+     */
+    struct SessionStats {
+        uint64_t sessions = 0;  // 已起播的会话数
+        uint64_t replayed = 0;  // 由 GOP 缓存起播的会话数
+        double last_ms = 0;     // 最近一次起播耗时
+        double avg_ms = 0;      // 平均起播耗时
+        double max_ms = 0;      // 最大起播耗时
+        double last_lag_ms = 0; // 最近一次起播画面滞后（端到端）
+        double avg_lag_ms = 0;  // 平均起播画面滞后
+        double max_lag_ms = 0;  // 最大起播画面滞后
+    };
+
+    /**
+     * 写入一帧视频
+     *
+     * 始终缓存当前 GOP；会话开始前只缓存，会话开始后同时封装发送
+     *
+     * @param packet 编码输出的一帧（H.264 / H.265，带起始码），90kHz 时间戳由其采集时间戳推导
+     */
+    void writeVideoFrame(const EncodedPacketPtr& packet);
+
+    /**
+     * 收到 INVITE：重置封装状态，记录起播计时起点
+     *
+     * @param codec 本次会话的编码格式，缓存的 GOP 格式不同时丢弃
+     * @param keep_gop_cache 缓存的 GOP 来自本次会话的档位（空闲期间该档位一直在编码）时保留，否则丢弃
+     * @return 是否有可回放的 GOP，没有时需要等待编码器输出 IDR
+     */
+    bool prepareSession(VideoCodec codec, bool keep_gop_cache);
+
+    /**
+     * 会话建立（200 OK 已发送）：立即回放缓存的 GOP，之后的帧直接发送
+     *
+     * 缓存跨度不超过 GOP_REPLAY_MAX_MS 时整组回放；否则只回放其中的 IDR（时间戳改为最新一帧的采集时刻），
+     * 之后的实时帧丢弃到下一个 IDR，避免播放端从几秒前的画面起播并一直落后
+     *
+     * @return 是否需要编码器尽快输出 IDR
+     */
+    bool startSession();
 
     void writeAudioFrame(const uint8_t* pcm_data, uint64_t pts_90k, size_t size);
 
     void release();
 
+    /**
+     * 90kHz 时钟的漂移/抖动统计
+     */
+    MediaClock::Stats getClockStats();
+
+    SessionStats getSessionStats();
+
 private:
     Logger _logger;
+    std::vector<uint8_t> _vps_cache{};
     std::vector<uint8_t> _sps_cache{};
     std::vector<uint8_t> _pps_cache{};
     bool _is_waiting_for_idr = true; // 等待接收IDR帧
+    uint8_t _video_stream_type = 0x1B; // PSM 中的视频 stream_type，随编码格式变化
     bool _is_idr_sent = false;
+    MediaClock _video_clock;
+    int64_t _last_stats_log_us = 0;
     std::mutex _muxer_mutex{};
+
+    // 当前 GOP（最近的 IDR 及其后的帧），新会话开始时回放
+    GopCache _gop_cache;
+    bool _is_session_started = false;
+    bool _is_replaying = false;
+    int64_t _invite_us = 0; // 收到 INVITE 的时刻（steady_clock），0 表示已统计
+    SessionStats _session_stats{};
+
+    /**
+     * 封装并发送一帧视频（调用方持有 _muxer_mutex）
+     *
+     * @param capture_us 用于推导时间戳的采集时刻，通常为 packet->captureUs()
+     */
+    void mux_video_frame(const EncodedPacketPtr& packet, int64_t capture_us);
+
+    /**
+     * 封装一帧为 PS 包并发送（调用方持有 _muxer_mutex）
+     */
+    void send_ps_packet(uint8_t stream_id, std::shared_ptr<const void> payload_owner, const uint8_t* payload,
+                        size_t len, uint64_t pts_90k, bool is_key_frame, bool is_droppable,
+                        const size_t* boundaries = nullptr, size_t boundary_count = 0);
+
+    /**
+     * @return 是否需要编码器尽快输出 IDR
+     */
+    bool replay_gop_cache();
+
+    /**
+     * 会话的第一个 IDR 已发出，记录起播耗时
+     */
+    void on_first_decodable_packet(int64_t capture_us);
+
+    void log_copy_stats();
 };
 
 #endif //GB28181CONSOLE_PS_MUXER_HPP
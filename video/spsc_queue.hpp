@@ -0,0 +1,199 @@
+//
+// Created by pengx on 2026/10/16.
+//
+
+#ifndef GB28181CONSOLE_SPSC_QUEUE_HPP
+#define GB28181CONSOLE_SPSC_QUEUE_HPP
+
+#include <atomic>
+#include <cerrno>
+#include <climits>
+#include <cstdint>
+#include <ctime>
+#include <utility>
+#include <vector>
+#include <unistd.h>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+
+/**
+ * 有界无锁单生产者/单消费者队列
+ *
+ * - 读写索引分别独占缓存行，生产者和消费者不会互相伪共享；
+ * - 正常路径只有原子读写，没有锁；只有消费者真正空等（parked）时，生产者才会发起一次 futex 唤醒；
+ * - 两种模式：
+ *   FIFO  ：有界环形队列，满时 push() 返回 false（丢弃新帧）；
+ *   LATEST：最新帧优先（三缓冲），push() 总是成功，未被取走的旧帧直接被覆盖并计入丢弃数，适合实时预览/推流。
+ *
+ * 必须严格保证只有一个线程 push、只有一个线程 pop。
+ * */
+template <typename T>
+class SpscQueue {
+public:
+    enum class Mode {
+        FIFO,
+        LATEST
+    };
+
+    /**
+     * @param capacity FIFO 模式下的容量（LATEST 模式忽略）
+     * @param mode 队列模式
+     */
+    explicit SpscQueue(const size_t capacity, const Mode mode = Mode::FIFO)
+        : _mode(mode), _capacity(mode == Mode::LATEST ? 3 : (capacity == 0 ? 1 : capacity)), _slots(_capacity) {}
+
+    SpscQueue(const SpscQueue&) = delete;
+
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    /**
+     * 生产者写入
+     *
+     * @return FIFO 满时返回 false；LATEST 模式总是 true
+     */
+    bool push(const T& item) {
+        if (_mode == Mode::LATEST) {
+            _slots[_back] = item;
+            const uint32_t previous = _middle.exchange(_back | DIRTY_BIT, std::memory_order_acq_rel);
+            _back = previous & INDEX_MASK;
+            if (previous & DIRTY_BIT) {
+                // 上一帧还没被消费者取走就被覆盖：立即释放，计入丢弃
+                _slots[_back] = T();
+                _dropped.fetch_add(1, std::memory_order_relaxed);
+            }
+        } else {
+            const size_t tail = _tail.load(std::memory_order_relaxed);
+            if (tail - _head.load(std::memory_order_acquire) >= _capacity) {
+                _dropped.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            _slots[tail % _capacity] = item;
+            _tail.store(tail + 1, std::memory_order_release);
+        }
+        notify();
+        return true;
+    }
+
+    /**
+     * 消费者非阻塞读取
+     */
+    bool tryPop(T& item) {
+        if (_mode == Mode::LATEST) {
+            if (!(_middle.load(std::memory_order_acquire) & DIRTY_BIT)) {
+                return false;
+            }
+            _front = _middle.exchange(_front, std::memory_order_acq_rel) & INDEX_MASK;
+            item = std::move(_slots[_front]);
+            _slots[_front] = T();
+            return true;
+        }
+
+        const size_t head = _head.load(std::memory_order_relaxed);
+        if (head == _tail.load(std::memory_order_acquire)) {
+            return false;
+        }
+        item = std::move(_slots[head % _capacity]);
+        _slots[head % _capacity] = T();
+        _head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * 消费者阻塞读取，队列为空时挂起在 futex 上
+     *
+     * @param timeout_ms 超时时间（毫秒）
+     * @return 是否取到数据（超时或被 wakeConsumer() 唤醒时返回 false）
+     */
+    bool waitPop(T& item, const int timeout_ms) {
+        if (tryPop(item)) {
+            return true;
+        }
+
+        const int seq = _wake_seq.load(std::memory_order_acquire);
+        _consumer_parked.store(true, std::memory_order_seq_cst);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        // 挂起前再检查一次，避免与生产者的唤醒错过
+        if (tryPop(item)) {
+            _consumer_parked.store(false, std::memory_order_relaxed);
+            return true;
+        }
+
+        timespec timeout{};
+        timeout.tv_sec = timeout_ms / 1000;
+        timeout.tv_nsec = static_cast<long>(timeout_ms % 1000) * 1000000;
+        syscall(SYS_futex, reinterpret_cast<int*>(&_wake_seq), FUTEX_WAIT_PRIVATE, seq, &timeout, nullptr, 0);
+        _consumer_parked.store(false, std::memory_order_relaxed);
+        return tryPop(item);
+    }
+
+    /**
+     * 强制唤醒消费者（停止时使用）
+     */
+    void wakeConsumer() {
+        _wake_seq.fetch_add(1, std::memory_order_release);
+        syscall(SYS_futex, reinterpret_cast<int*>(&_wake_seq), FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0);
+    }
+
+    /**
+     * 清空队列，只能在生产者和消费者都已停止后调用
+     */
+    void clear() {
+        for (auto& slot : _slots) {
+            slot = T();
+        }
+        _head.store(0, std::memory_order_relaxed);
+        _tail.store(0, std::memory_order_relaxed);
+        // LATEST 的三个槽位索引必须一起复位，否则前台/后台可能与中间槽位指向同一槽位
+        _front = 0;
+        _back = 2;
+        _middle.store(1, std::memory_order_relaxed);
+    }
+
+    size_t size() const {
+        if (_mode == Mode::LATEST) {
+            return (_middle.load(std::memory_order_acquire) & DIRTY_BIT) ? 1 : 0;
+        }
+        return _tail.load(std::memory_order_acquire) - _head.load(std::memory_order_acquire);
+    }
+
+    uint64_t droppedCount() const {
+        return _dropped.load(std::memory_order_relaxed);
+    }
+
+private:
+    static constexpr size_t CACHE_LINE = 64;
+    static constexpr uint32_t DIRTY_BIT = 0x4;
+    static constexpr uint32_t INDEX_MASK = 0x3;
+
+    const Mode _mode;
+    const size_t _capacity;
+    std::vector<T> _slots;
+
+    // 消费者独占：FIFO 读索引 / LATEST 前台槽位
+    std::atomic<size_t> _head{0};
+    uint32_t _front = 0;
+    char _pad0[CACHE_LINE]{};
+
+    // 生产者独占：FIFO 写索引 / LATEST 后台槽位
+    std::atomic<size_t> _tail{0};
+    uint32_t _back = 2;
+    char _pad1[CACHE_LINE]{};
+
+    // 共享：LATEST 中间槽位（低 2 位索引 + 脏标记）、唤醒相关
+    std::atomic<uint32_t> _middle{1};
+    std::atomic<int> _wake_seq{0};
+    std::atomic<bool> _consumer_parked{false};
+    std::atomic<uint64_t> _dropped{0};
+    char _pad2[CACHE_LINE]{};
+
+    void notify() {
+        // 与消费者的 parked 标记构成 Dekker 同步：发布数据之后再检查对方是否已挂起
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (_consumer_parked.load(std::memory_order_relaxed)) {
+            _wake_seq.fetch_add(1, std::memory_order_release);
+            syscall(SYS_futex, reinterpret_cast<int*>(&_wake_seq), FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr, 0);
+        }
+    }
+};
+
+#endif //GB28181CONSOLE_SPSC_QUEUE_HPP
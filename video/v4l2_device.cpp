@@ -0,0 +1,269 @@
+//
+// Created by pengx on 2026/10/16.
+//
+
+#include "v4l2_device.hpp"
+
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <utility>
+#include <linux/videodev2.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+
+V4l2Device::V4l2Device(std::string device_path) : _logger("V4l2Device"), _device_path(std::move(device_path)) {
+    _logger.i("V4l2Device created");
+}
+
+V4l2Device::~V4l2Device() {
+    close();
+}
+
+bool V4l2Device::open(const int width, const int height, const int fps, const uint32_t pixel_format,
+                      const uint32_t buffer_count) {
+    if (_fd >= 0) {
+        close();
+    }
+
+    _fd = ::open(_device_path.c_str(), O_RDWR | O_NONBLOCK);
+    if (_fd < 0) {
+        _logger.eFmt("Cannot open %s: %s", _device_path.c_str(), strerror(errno));
+        return false;
+    }
+
+    v4l2_capability cap{};
+    if (xioctl(VIDIOC_QUERYCAP, &cap) < 0) {
+        _logger.eFmt("VIDIOC_QUERYCAP failed: %s", strerror(errno));
+        close();
+        return false;
+    }
+    if (!(cap.capabilities & V4L2_CAP_VIDEO_CAPTURE) || !(cap.capabilities & V4L2_CAP_STREAMING)) {
+        _logger.eFmt("%s does not support streaming capture", _device_path.c_str());
+        close();
+        return false;
+    }
+
+    // 协商分辨率和像素格式，驱动可能会修改为最接近的值
+    v4l2_format fmt{};
+    fmt.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    fmt.fmt.pix.width = width;
+    fmt.fmt.pix.height = height;
+    fmt.fmt.pix.pixelformat = pixel_format;
+    fmt.fmt.pix.field = V4L2_FIELD_NONE;
+    if (xioctl(VIDIOC_S_FMT, &fmt) < 0) {
+        _logger.eFmt("VIDIOC_S_FMT failed: %s", strerror(errno));
+        close();
+        return false;
+    }
+    if (fmt.fmt.pix.pixelformat != pixel_format) {
+        _logger.wFmt("Pixel format %.4s not supported by %s", reinterpret_cast<const char*>(&pixel_format),
+                     _device_path.c_str());
+        close();
+        return false;
+    }
+    _width = static_cast<int>(fmt.fmt.pix.width);
+    _height = static_cast<int>(fmt.fmt.pix.height);
+    _pixel_format = fmt.fmt.pix.pixelformat;
+    _bytes_per_line = fmt.fmt.pix.bytesperline;
+    _frame_size = fmt.fmt.pix.sizeimage;
+
+    // 下游按 bytesperline × 高度（4:2:0 格式再加半幅色度）读取整帧，sizeimage 可能含驱动的对齐填充，取两者较小值
+    const bool is_yuv420 = _pixel_format == V4L2_PIX_FMT_YUV420 || _pixel_format == V4L2_PIX_FMT_NV12;
+    const uint32_t plane_size = _bytes_per_line * static_cast<uint32_t>(_height);
+    const uint32_t image_size = is_yuv420 ? plane_size * 3 / 2 : plane_size;
+    _min_bytes_used = image_size > 0 && image_size < _frame_size ? image_size : _frame_size;
+
+    // 帧率，部分虚拟设备不支持，失败不影响采集
+    v4l2_streamparm parm{};
+    parm.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    parm.parm.capture.timeperframe.numerator = 1;
+    parm.parm.capture.timeperframe.denominator = fps;
+    if (xioctl(VIDIOC_S_PARM, &parm) < 0) {
+        _logger.wFmt("VIDIOC_S_PARM failed: %s", strerror(errno));
+    }
+
+    if (!request_buffers(buffer_count)) {
+        close();
+        return false;
+    }
+
+    _logger.dBox()
+           .add("V4L2 device opened")
+           .addFmt("Device: %s", _device_path.c_str())
+           .addFmt("Format: %.4s %dx%d", reinterpret_cast<const char*>(&_pixel_format), _width, _height)
+           .addFmt("Bytes per line: %u", _bytes_per_line)
+           .addFmt("Buffers: %zu", _buffers.size())
+           .print();
+    return true;
+}
+
+bool V4l2Device::request_buffers(const uint32_t buffer_count) {
+    v4l2_requestbuffers req{};
+    req.count = buffer_count;
+    req.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    req.memory = V4L2_MEMORY_MMAP;
+    if (xioctl(VIDIOC_REQBUFS, &req) < 0) {
+        _logger.eFmt("VIDIOC_REQBUFS failed: %s", strerror(errno));
+        return false;
+    }
+    if (req.count < 2) {
+        _logger.eFmt("Insufficient buffer memory, only %u buffers", req.count);
+        return false;
+    }
+
+    _buffers.resize(req.count);
+    for (uint32_t i = 0; i < req.count; ++i) {
+        v4l2_buffer buf{};
+        buf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+        buf.memory = V4L2_MEMORY_MMAP;
+        buf.index = i;
+        if (xioctl(VIDIOC_QUERYBUF, &buf) < 0) {
+            _logger.eFmt("VIDIOC_QUERYBUF failed: %s", strerror(errno));
+            release_buffers();
+            return false;
+        }
+
+        void* start = mmap(nullptr, buf.length, PROT_READ | PROT_WRITE, MAP_SHARED, _fd, buf.m.offset);
+        if (start == MAP_FAILED) {
+            _logger.eFmt("mmap failed: %s", strerror(errno));
+            release_buffers();
+            return false;
+        }
+        _buffers[i].start = start;
+        _buffers[i].length = buf.length;
+    }
+    return true;
+}
+
+void V4l2Device::release_buffers() {
+    for (auto& buffer : _buffers) {
+        if (buffer.start) {
+            munmap(buffer.start, buffer.length);
+        }
+    }
+    _buffers.clear();
+
+    if (_fd >= 0) {
+        // count=0 释放驱动端缓冲区
+        v4l2_requestbuffers req{};
+        req.count = 0;
+        req.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+        req.memory = V4L2_MEMORY_MMAP;
+        xioctl(VIDIOC_REQBUFS, &req);
+    }
+}
+
+bool V4l2Device::startStreaming() {
+    if (_fd < 0 || _buffers.empty()) {
+        return false;
+    }
+
+    // 所有缓冲区先入队
+    for (uint32_t i = 0; i < _buffers.size(); ++i) {
+        if (!enqueue(i)) {
+            return false;
+        }
+    }
+
+    v4l2_buf_type type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    if (xioctl(VIDIOC_STREAMON, &type) < 0) {
+        _logger.eFmt("VIDIOC_STREAMON failed: %s", strerror(errno));
+        return false;
+    }
+    _is_streaming = true;
+    return true;
+}
+
+void V4l2Device::stopStreaming() {
+    if (_fd < 0 || !_is_streaming) {
+        return;
+    }
+    v4l2_buf_type type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    if (xioctl(VIDIOC_STREAMOFF, &type) < 0) {
+        _logger.eFmt("VIDIOC_STREAMOFF failed: %s", strerror(errno));
+    }
+    _is_streaming = false;
+}
+
+void V4l2Device::close() {
+    stopStreaming();
+    release_buffers();
+    if (_fd >= 0) {
+        ::close(_fd);
+        _fd = -1;
+    }
+}
+
+bool V4l2Device::waitFrame(const int timeout_ms) const {
+    pollfd pfd{};
+    pfd.fd = _fd;
+    pfd.events = POLLIN;
+    const int ret = poll(&pfd, 1, timeout_ms);
+    return ret > 0 && (pfd.revents & POLLIN);
+}
+
+bool V4l2Device::dequeue(Buffer& buffer) {
+    v4l2_buffer buf{};
+    buf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    buf.memory = V4L2_MEMORY_MMAP;
+    if (xioctl(VIDIOC_DQBUF, &buf) < 0) {
+        if (errno != EAGAIN) {
+            _logger.eFmt("VIDIOC_DQBUF failed: %s", strerror(errno));
+        }
+        return false;
+    }
+    if (buf.index >= _buffers.size()) {
+        _logger.eFmt("Invalid buffer index %u", buf.index);
+        return false;
+    }
+
+    // 驱动出错（如 USB 传输丢包）或数据不足一帧：直接归还驱动，帧序号不连续即体现为丢帧
+    if ((buf.flags & V4L2_BUF_FLAG_ERROR) || buf.bytesused < _min_bytes_used) {
+        const uint64_t rejected = _rejected_frames.fetch_add(1, std::memory_order_relaxed) + 1;
+        if (rejected == 1 || rejected % 100 == 0) {
+            _logger.wFmt("Dropped %s frame #%u (%u of %u bytes), %llu so far",
+                         (buf.flags & V4L2_BUF_FLAG_ERROR) ? "corrupted" : "incomplete", buf.sequence, buf.bytesused,
+                         _min_bytes_used, static_cast<unsigned long long>(rejected));
+        }
+        enqueue(buf.index);
+        return false;
+    }
+
+    buffer.data = static_cast<const uint8_t*>(_buffers[buf.index].start);
+    buffer.size = buf.bytesused;
+    buffer.index = buf.index;
+    buffer.sequence = buf.sequence;
+
+    // 驱动使用单调时钟时直接取内核时间戳，否则退化为出队时刻
+    if ((buf.flags & V4L2_BUF_FLAG_TIMESTAMP_MASK) == V4L2_BUF_FLAG_TIMESTAMP_MONOTONIC) {
+        buffer.timestamp_us = static_cast<int64_t>(buf.timestamp.tv_sec) * 1000000 + buf.timestamp.tv_usec;
+    } else {
+        buffer.timestamp_us = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+    return true;
+}
+
+bool V4l2Device::enqueue(const uint32_t index) {
+    v4l2_buffer buf{};
+    buf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    buf.memory = V4L2_MEMORY_MMAP;
+    buf.index = index;
+    if (xioctl(VIDIOC_QBUF, &buf) < 0) {
+        _logger.eFmt("VIDIOC_QBUF failed: %s", strerror(errno));
+        return false;
+    }
+    return true;
+}
+
+int V4l2Device::xioctl(const unsigned long request, void* arg) const {
+    int ret;
+    do {
+        ret = ioctl(_fd, request, arg);
+    } while (ret < 0 && errno == EINTR);
+    return ret;
+}
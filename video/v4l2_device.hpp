@@ -0,0 +1,164 @@
+//
+// Created by pengx on 2026/10/16.
+//
+
+#ifndef GB28181CONSOLE_V4L2_DEVICE_HPP
+#define GB28181CONSOLE_V4L2_DEVICE_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "logger.hpp"
+
+/**
+ * V4L2 原生采集设备（mmap 方式）
+ *
+ * 流程：open(S_FMT/S_PARM) -> REQBUFS -> mmap -> QBUF -> STREAMON -> [DQBUF -> 使用 -> QBUF]...
+ *
+ * dequeue() 拿到的是驱动缓冲区本身（不拷贝），使用完后必须调用 enqueue() 归还给驱动（可在任意线程调用），
+ * 否则驱动队列会被耗尽而停止出帧。
+ * 驱动标记出错（V4L2_BUF_FLAG_ERROR）或有效数据不足一帧（bytesused 小于协商的帧长度）的缓冲区不交给调用方，
+ * 由 dequeue() 直接归还驱动并计数，避免下游按整帧读取时读到上一帧残留或未写入的数据。
+ * */
+class V4l2Device {
+public:
+    /**
+     * 驱动缓冲区视图
+     */
+    struct Buffer {
+        const uint8_t* data = nullptr; // mmap 地址
+        size_t size = 0;               // 有效数据长度（bytesused）
+        uint32_t index = 0;            // 驱动缓冲区索引，归还时使用
+        uint32_t sequence = 0;         // 驱动帧序号，可用于判断丢帧
+        int64_t timestamp_us = 0;      // 内核采集时间戳（CLOCK_MONOTONIC，微秒）
+    };
+
+    /**
+     * @param device_path 设备节点，如 /dev/video0（v4l2loopback 同样适用）
+     */
+    explicit V4l2Device(std::string device_path);
+
+    ~V4l2Device();
+
+    V4l2Device(const V4l2Device&) = delete;
+
+    V4l2Device& operator=(const V4l2Device&) = delete;
+
+    /**
+     * 打开设备并协商格式、申请 mmap 缓冲区
+     *
+     * @param width 期望宽度
+     * @param height 期望高度
+     * @param fps 期望帧率
+     * @param pixel_format 期望像素格式（V4L2_PIX_FMT_*）
+     * @param buffer_count 驱动队列深度
+     * @return 是否成功，失败时设备已关闭
+     */
+    bool open(int width, int height, int fps, uint32_t pixel_format, uint32_t buffer_count);
+
+    bool startStreaming();
+
+    void stopStreaming();
+
+    void close();
+
+    bool isOpened() const {
+        return _fd >= 0;
+    }
+
+    /**
+     * 等待下一帧就绪
+     *
+     * @param timeout_ms 超时时间（毫秒）
+     * @return 是否有帧可取
+     */
+    bool waitFrame(int timeout_ms) const;
+
+    /**
+     * 取出一帧（借用驱动缓冲区）
+     *
+     * @return 是否取到完整的一帧；驱动缓冲区出错或数据不完整时已归还驱动，返回 false
+     */
+    bool dequeue(Buffer& buffer);
+
+    /**
+     * 归还驱动缓冲区
+     */
+    bool enqueue(uint32_t index);
+
+    int width() const {
+        return _width;
+    }
+
+    int height() const {
+        return _height;
+    }
+
+    uint32_t pixelFormat() const {
+        return _pixel_format;
+    }
+
+    uint32_t bytesPerLine() const {
+        return _bytes_per_line;
+    }
+
+    uint32_t frameSize() const {
+        return _frame_size;
+    }
+
+    /**
+     * 因出错或数据不完整被丢弃（直接归还驱动）的帧数
+     */
+    uint64_t rejectedFrames() const {
+        return _rejected_frames.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * 驱动实际分配的缓冲区个数（可能少于请求的个数）
+     */
+    size_t bufferCount() const {
+        return _buffers.size();
+    }
+
+    /**
+     * 驱动缓冲区的 mmap 地址，close() 之前有效
+     */
+    uint8_t* bufferData(const uint32_t index) const {
+        return static_cast<uint8_t*>(_buffers[index].start);
+    }
+
+    size_t bufferLength(const uint32_t index) const {
+        return _buffers[index].length;
+    }
+
+private:
+    struct MappedBuffer {
+        void* start = nullptr;
+        size_t length = 0;
+    };
+
+    Logger _logger;
+    std::string _device_path;
+    int _fd = -1;
+    bool _is_streaming = false;
+
+    int _width = 0;
+    int _height = 0;
+    uint32_t _pixel_format = 0;
+    uint32_t _bytes_per_line = 0;
+    uint32_t _frame_size = 0;
+    uint32_t _min_bytes_used = 0; // 一帧有效数据的最小长度，bytesused 小于此值的缓冲区视为不完整
+    std::atomic<uint64_t> _rejected_frames{0};
+
+    std::vector<MappedBuffer> _buffers{};
+
+    bool request_buffers(uint32_t buffer_count);
+
+    void release_buffers();
+
+    int xioctl(unsigned long request, void* arg) const;
+};
+
+#endif //GB28181CONSOLE_V4L2_DEVICE_HPP
@@ -0,0 +1,24 @@
+//
+// Created by pengx on 2026/10/16.
+//
+
+#ifndef GB28181CONSOLE_VIDEO_CODEC_HPP
+#define GB28181CONSOLE_VIDEO_CODEC_HPP
+
+/**
+ * 视频编码格式
+ *
+ * GB28181 中的对应关系：
+ * - SDP f= 行视频编码格式：2 = H.264，5 = H.265
+ * - PSM stream_type：0x1B = H.264，0x24 = H.265
+ */
+enum class VideoCodec {
+    H264,
+    H265
+};
+
+inline const char* videoCodecName(const VideoCodec codec) {
+    return codec == VideoCodec::H265 ? "H.265" : "H.264";
+}
+
+#endif //GB28181CONSOLE_VIDEO_CODEC_HPP
@@ -0,0 +1,41 @@
+//
+// Created by pengx on 2026/10/16.
+//
+
+#ifndef GB28181CONSOLE_VIDEO_FRAME_HPP
+#define GB28181CONSOLE_VIDEO_FRAME_HPP
+
+#include <cstdint>
+#include <opencv2/core/mat.hpp>
+
+/**
+ * 采集帧像素格式
+ *
+ * cv::Mat 内存布局约定（与 OpenCV 的 YUV 约定一致）：
+ * - BGR24: CV_8UC3，rows = height
+ * - YUYV : CV_8UC2，rows = height（YUYV 4:2:2 打包）
+ * - NV12 : CV_8UC1，rows = height * 3 / 2（Y 平面 + UV 交错平面，步长同 Y）
+ * - I420 : CV_8UC1，rows = height * 3 / 2（Y 平面 + U 平面 + V 平面，色度步长为 Y 的一半）
+ */
+enum class PixelFormat {
+    BGR24,
+    YUYV,
+    NV12,
+    I420
+};
+
+/**
+ * 采集帧：图像数据 + 像素格式 + 采集时间戳
+ *
+ * timestamp_us 为 CLOCK_MONOTONIC（与 std::chrono::steady_clock 同源）下的微秒数，
+ * 从采集一路透传到编码器和 PS 封装，90kHz 时间戳由它推导，而不是按帧计数推算。
+ * */
+struct VideoFrame {
+    cv::Mat mat;
+    PixelFormat format = PixelFormat::BGR24;
+    int width = 0;
+    int height = 0;
+    int64_t timestamp_us = 0;
+};
+
+#endif //GB28181CONSOLE_VIDEO_FRAME_HPP
@@ -0,0 +1,48 @@
+//
+// Created by pengx on 2026/10/16.
+//
+
+#include "video_profile.hpp"
+
+#include "base_config.hpp"
+
+extern "C" {
+#include <libavcodec/avcodec.h>
+}
+
+VideoProfiles::VideoProfiles() : _logger("VideoProfiles") {
+    _profiles.push_back({"main", VIDEO_WIDTH, VIDEO_HEIGHT, VIDEO_FPS, VIDEO_BIT_RATE});
+    _profiles.push_back({"sub", SUB_VIDEO_WIDTH, SUB_VIDEO_HEIGHT, VIDEO_FPS, SUB_VIDEO_BIT_RATE});
+    _default_codec = VIDEO_CODEC_H265 ? VideoCodec::H265 : VideoCodec::H264;
+    _default_codec = selectCodec(_default_codec);
+    _logger.iFmt("VideoProfiles created, default codec: %s", videoCodecName(_default_codec));
+}
+
+bool VideoProfiles::isCodecAvailable(const VideoCodec codec) {
+    return avcodec_find_encoder(codec == VideoCodec::H265 ? AV_CODEC_ID_HEVC : AV_CODEC_ID_H264) != nullptr;
+}
+
+VideoCodec VideoProfiles::selectCodec(VideoCodec codec) {
+    if (codec != VideoCodec::H264 && !isCodecAvailable(codec)) {
+        _logger.wFmt("%s encoder not available, fallback to H.264", videoCodecName(codec));
+        codec = VideoCodec::H264;
+    }
+    _selected_codec.store(static_cast<int>(codec), std::memory_order_release);
+    return codec;
+}
+
+int VideoProfiles::select(const int stream_number) {
+    int index = stream_number;
+    if (index < 0 || index >= static_cast<int>(_profiles.size())) {
+        index = 0;
+    }
+    _selected.store(index, std::memory_order_release);
+
+    const auto& profile = _profiles[index];
+    _logger.dBox()
+           .addFmt("码流编号: %d", stream_number)
+           .addFmt("推送档位: %s %dx%d@%d %lld bps", profile.name.c_str(), profile.width, profile.height, profile.fps,
+                   static_cast<long long>(profile.bit_rate))
+           .print();
+    return index;
+}
@@ -0,0 +1,94 @@
+//
+// Created by pengx on 2026/10/16.
+//
+
+#ifndef GB28181CONSOLE_VIDEO_PROFILE_HPP
+#define GB28181CONSOLE_VIDEO_PROFILE_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "logger.hpp"
+#include "video_codec.hpp"
+
+/**
+ * 编码档位（主码流 / 子码流 ...）
+ */
+struct VideoProfile {
+    std::string name;     // 档位名称，仅用于日志
+    int width = 0;        // 编码宽度，与采集分辨率不同时编码器会缩放一次
+    int height = 0;       // 编码高度
+    int fps = 0;          // 标称帧率
+    int64_t bit_rate = 0; // 目标码率（bps）
+};
+
+/**
+ * 编码档位表
+ *
+ * 一路采集同时喂给每个档位各自的编码器，平台点播时按 INVITE 中的码流编号选择推送哪个档位：
+ * 0 = 主码流（全屏观看），1 = 子码流（多画面拼接），超出范围时使用主码流。
+ * */
+class VideoProfiles {
+public:
+    explicit VideoProfiles();
+
+    static VideoProfiles* get() {
+        static VideoProfiles instance;
+        return &instance;
+    }
+
+    VideoProfiles(const VideoProfiles&) = delete;
+
+    VideoProfiles& operator=(const VideoProfiles&) = delete;
+
+    const std::vector<VideoProfile>& profiles() const {
+        return _profiles;
+    }
+
+    /**
+     * 按码流编号选择推送的档位
+     *
+     * @param stream_number 码流编号，小于 0 或超出范围时选择主码流
+     * @return 实际选中的档位下标
+     */
+    int select(int stream_number);
+
+    /**
+     * 当前推送的档位下标
+     */
+    int selected() const {
+        return _selected.load(std::memory_order_acquire);
+    }
+
+    /**
+     * 选择本次会话的编码格式，当前环境没有对应编码器（如缺少 libx265）时回退到 H.264
+     *
+     * @param codec 平台要求（或默认）的编码格式
+     * @return 实际使用的编码格式
+     */
+    VideoCodec selectCodec(VideoCodec codec);
+
+    VideoCodec selectedCodec() const {
+        return static_cast<VideoCodec>(_selected_codec.load(std::memory_order_acquire));
+    }
+
+    /**
+     * 默认编码格式（VIDEO_CODEC_H265），平台未指定时使用
+     */
+    VideoCodec defaultCodec() const {
+        return _default_codec;
+    }
+
+    static bool isCodecAvailable(VideoCodec codec);
+
+private:
+    Logger _logger;
+    std::vector<VideoProfile> _profiles;
+    std::atomic<int> _selected{0};
+    VideoCodec _default_codec = VideoCodec::H264;
+    std::atomic<int> _selected_codec{static_cast<int>(VideoCodec::H264)};
+};
+
+#endif //GB28181CONSOLE_VIDEO_PROFILE_HPP